@@ -17,6 +17,30 @@ class AppDelegate: UIResponder, UIApplicationDelegate {
         UINavigationBar.appearance().largeTitleTextAttributes = [NSAttributedString.Key.foregroundColor:UIColor(named: "AccentColor") ?? UIColor.black]
         UINavigationBar.appearance().titleTextAttributes = [NSAttributedString.Key.foregroundColor:UIColor(named: "AccentColor") ?? UIColor.white]
 
+        #if DEBUG
+        if ProcessInfo.processInfo.arguments.contains("-MercatorProjectionBenchmark"),
+           let directoryPath = Bundle.main.resourceURL?.appendingPathComponent("Maps/AVF/AMS").path {
+            _ = MercatorProjection.benchmark(directoryPath: directoryPath)
+        }
+        if ProcessInfo.processInfo.arguments.contains("-VenueBenchmark") {
+            let baselinePath = UserDefaults.standard.string(forKey: "VenueBenchmarkBaseline")
+            let scales = (UserDefaults.standard.string(forKey: "VenueBenchmarkScales") ?? "").split(separator: ",").compactMap { Int($0) }
+            VenueBenchmark.runBundledVenues(baselineDirectory: baselinePath.map { URL(fileURLWithPath: $0, isDirectory: true) },
+                                            scales: scales)
+        }
+        if let requestsPath = UserDefaults.standard.string(forKey: "BatchRouteRequests"),
+           let documentsURL = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first {
+            VenueRegistry.shared.preload(airportCode: "AMS") { venue in
+                venue?.publishSnapshot { snapshot in
+                    guard let snapshot = snapshot else { return }
+
+                    BatchRouter(snapshot: snapshot).answerRequests(contentsOf: URL(fileURLWithPath: requestsPath),
+                                                                   writingTo: documentsURL.appendingPathComponent("BatchRouteAnswers.ndjson")) { _ in }
+                }
+            }
+        }
+        #endif
+
         return true
     }
 
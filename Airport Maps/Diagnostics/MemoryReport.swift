@@ -0,0 +1,104 @@
+//
+//  MemoryReport.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import Foundation
+import os.log
+
+// Memory held by a resident venue per subsystem and layer. App side structures report the size of the
+// arrays and tables they store; the manager's features are closed to the app and are estimated by the size
+// of their GeoJSON file. Building a report only reads sizes and builds nothing, so it can be polled.
+struct MemoryReport {
+    enum Subsystem: String, CaseIterable {
+        case features // PC_IndoorMapManager, estimated
+        case geometry
+        case spatialIndex
+        case navigationGraph
+        case routeMetric
+        case routes
+        case caches
+    }
+
+    struct Entry {
+        let subsystem: Subsystem
+        let layer: String?
+        let byteCount: Int
+    }
+
+    let airportCode: String
+    let entries: [Entry]
+
+    var byteCount: Int {
+        return entries.reduce(0) { $0 + $1.byteCount }
+    }
+
+    func byteCount(of subsystem: Subsystem) -> Int {
+        return entries.filter { $0.subsystem == subsystem }.reduce(0) { $0 + $1.byteCount }
+    }
+
+    init(venue: ResidentVenue) {
+        var entries: [Entry] = []
+
+        for (layer, byteCount) in venue.sourceByteCounts {
+            entries.append(Entry(subsystem: .features, layer: layer, byteCount: byteCount))
+        }
+
+        if let geometry = venue.geometry {
+            for (layer, byteCount) in geometry.layerByteCounts {
+                entries.append(Entry(subsystem: .geometry, layer: layer, byteCount: byteCount))
+            }
+            entries.append(Entry(subsystem: .spatialIndex, layer: nil, byteCount: geometry.indexByteCount))
+        }
+
+        if let graph = venue.builtNavigationGraph {
+            entries.append(Entry(subsystem: .navigationGraph, layer: nil, byteCount: graph.byteCount))
+        }
+
+        if let routePlanner = venue.builtRoutePlanner {
+            entries.append(Entry(subsystem: .routeMetric, layer: nil, byteCount: routePlanner.metric.byteCount))
+            entries.append(Entry(subsystem: .routes, layer: nil, byteCount: routePlanner.routeByteCount))
+        }
+
+        if let routeStepBuilder = venue.builtRouteStepBuilder {
+            entries.append(Entry(subsystem: .spatialIndex, layer: "Landmarks", byteCount: routeStepBuilder.landmarkIndexByteCount))
+            entries.append(Entry(subsystem: .caches, layer: "Landmarks", byteCount: routeStepBuilder.cacheByteCount))
+        }
+
+        // The feature list holds a reference per feature, identifier and unit lookups a key and a reference
+        let referenceByteCount = MemoryLayout<String>.stride + MemoryLayout<PC_IndoorMapFeature>.stride
+        entries.append(Entry(subsystem: .caches, layer: nil,
+                             byteCount: venue.features.count * MemoryLayout<PC_IndoorMapFeature>.stride
+                                + venue.featuresByIdentifier.count * referenceByteCount
+                                + (venue.builtFeaturesByUnit?.values.reduce(0) { $0 + $1.count * referenceByteCount } ?? 0)))
+
+        self.airportCode = venue.airportCode
+        self.entries = entries
+    }
+
+    // Memory the system charges to the app, the figure jetsam limits apply to
+    static func physicalFootprint() -> Int? {
+        var info = task_vm_info_data_t()
+        var count = mach_msg_type_number_t(MemoryLayout<task_vm_info_data_t>.size / MemoryLayout<natural_t>.size)
+
+        let result = withUnsafeMutablePointer(to: &info) { pointer in
+            pointer.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+                task_info(mach_task_self_, task_flavor_t(TASK_VM_INFO), $0, &count)
+            }
+        }
+
+        return result == KERN_SUCCESS ? Int(info.phys_footprint) : nil
+    }
+
+    func log() {
+        for subsystem in Subsystem.allCases {
+            let byteCount = self.byteCount(of: subsystem)
+            if byteCount > 0 {
+                os_log("%{public}@ %{public}@: %ld bytes", type: .info, airportCode, subsystem.rawValue, byteCount)
+            }
+        }
+        os_log("%{public}@ total: %ld bytes, footprint %ld bytes", type: .info, airportCode, byteCount, MemoryReport.physicalFootprint() ?? 0)
+    }
+}
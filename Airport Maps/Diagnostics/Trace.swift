@@ -0,0 +1,254 @@
+//
+//  Trace.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import Foundation
+import QuartzCore
+import os
+
+// Scoped timing spans for the hot paths: loading, search, render preparation, routing and location updates.
+// Spans are only recorded when the TRACE compilation condition is set, otherwise `span` calls its body
+// and nothing else. Every thread writes into its own ring buffer of the most recent spans and its own
+// counters, so threads never wait on each other; a buffer's lock is only contended while dumping.
+// The buffer of an exited thread is handed to the next new thread, and at most `maximumBufferCount`
+// buffers exist, beyond that threads share them. `dump()` writes everything out when the app is backgrounded.
+enum Trace {
+    struct Counter: Codable {
+        var calls = 0
+        var totalDuration: TimeInterval = 0
+        var maxDuration: TimeInterval = 0
+    }
+
+    // Spans kept per thread, older spans are overwritten
+    static let bufferCapacity = 4096
+    static let maximumBufferCount = 32
+
+    @inline(__always)
+    static func span<T>(_ name: StaticString, _ body: () throws -> T) rethrows -> T {
+        #if TRACE
+        let startTime = CACurrentMediaTime()
+        defer {
+            ThreadBuffer.current.record(name, startTime: startTime, endTime: CACurrentMediaTime())
+        }
+        #endif
+        return try body()
+    }
+
+    // For spans that end in a callback, `end` must be given the time returned by `begin`
+    @inline(__always)
+    static func begin() -> TimeInterval {
+        #if TRACE
+        return CACurrentMediaTime()
+        #else
+        return 0
+        #endif
+    }
+
+    @inline(__always)
+    static func end(_ name: StaticString, startTime: TimeInterval) {
+        #if TRACE
+        ThreadBuffer.current.record(name, startTime: startTime, endTime: CACurrentMediaTime())
+        #endif
+    }
+
+    // Calls, total and maximum duration per span name over all threads since launch
+    static func counters() -> [String: Counter] {
+        var counters: [String: Counter] = [:]
+
+        #if TRACE
+        for buffer in ThreadBuffer.all() {
+            for (name, counter) in buffer.snapshot().counters {
+                var total = counters[name, default: Counter()]
+                total.calls += counter.calls
+                total.totalDuration += counter.totalDuration
+                total.maxDuration = max(total.maxDuration, counter.maxDuration)
+                counters[name] = total
+            }
+        }
+        #endif
+
+        return counters
+    }
+
+    // The buffered spans of all threads in the Chrome trace event format, for chrome://tracing or Perfetto
+    static func chromeTraceJSON() -> Data {
+        var events: [[String: Any]] = []
+
+        #if TRACE
+        let processIdentifier = Int(ProcessInfo.processInfo.processIdentifier)
+        for buffer in ThreadBuffer.all() {
+            events.append(["name": "thread_name", "ph": "M", "pid": processIdentifier, "tid": buffer.threadIndex,
+                           "args": ["name": buffer.threadName]])
+
+            for span in buffer.snapshot().spans {
+                events.append(["name": span.name.description, "ph": "X", "pid": processIdentifier, "tid": buffer.threadIndex,
+                               "ts": span.startTime * 1_000_000, "dur": span.duration * 1_000_000])
+            }
+        }
+        #endif
+
+        return (try? JSONSerialization.data(withJSONObject: ["traceEvents": events], options: [])) ?? Data()
+    }
+
+    // Writes the Chrome trace to Trace.json in the Documents directory and logs the counters
+    static func dump() {
+        #if TRACE
+        guard let documentsURL = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first else { return }
+
+        let url = documentsURL.appendingPathComponent("Trace.json")
+        do {
+            try chromeTraceJSON().write(to: url, options: .atomic)
+        } catch {
+            os_log("Could not write trace: %{public}@", type: .error, error.localizedDescription)
+        }
+
+        for (name, counter) in counters().sorted(by: { $0.value.totalDuration > $1.value.totalDuration }) {
+            os_log("Trace %{public}@: %ld calls, %.3f ms total, %.3f ms max", type: .info, name, counter.calls,
+                   counter.totalDuration * 1000, counter.maxDuration * 1000)
+        }
+        #endif
+    }
+}
+
+#if TRACE
+private final class ThreadBuffer {
+    struct Span {
+        let name: StaticString
+        let startTime: TimeInterval
+        let duration: TimeInterval
+    }
+
+    let threadIndex: Int
+    let threadName: String
+
+    // Locks live on the heap, a Swift stored property has no stable address to hand to os_unfair_lock
+    private let lock = ThreadBuffer.makeLock()
+    private var spans: [Span] = []
+    private var nextSpan = 0
+    // Counters are keyed by the address of the span name, a thread only ever sees a handful of names
+    private var counterKeys: [UInt] = []
+    private var counterNames: [StaticString] = []
+    private var counters: [Trace.Counter] = []
+
+    private static let registryLock = makeLock()
+    private static var buffers: [ThreadBuffer] = []
+    private static var freeBuffers: [ThreadBuffer] = []
+    private static var nextSharedBuffer = 0
+
+    // The destructor runs when a thread exits and returns its buffer for reuse
+    private static let threadKey: pthread_key_t = {
+        var key = pthread_key_t()
+        pthread_key_create(&key) { pointer in
+            ThreadBuffer.recycle(Unmanaged<ThreadBuffer>.fromOpaque(pointer).takeUnretainedValue())
+        }
+        return key
+    }()
+
+    // Buffers are kept in `buffers` for the life of the process, so the thread-specific pointer stays valid
+    static var current: ThreadBuffer {
+        if let pointer = pthread_getspecific(threadKey) {
+            return Unmanaged<ThreadBuffer>.fromOpaque(pointer).takeUnretainedValue()
+        }
+
+        os_unfair_lock_lock(registryLock)
+        let buffer: ThreadBuffer
+        if let freeBuffer = freeBuffers.popLast() {
+            buffer = freeBuffer
+        } else if buffers.count < Trace.maximumBufferCount {
+            buffer = ThreadBuffer(threadIndex: buffers.count,
+                                  threadName: Thread.isMainThread ? "main" : Thread.current.name ?? "")
+            buffers.append(buffer)
+        } else {
+            buffer = buffers[nextSharedBuffer % buffers.count]
+            nextSharedBuffer += 1
+        }
+        os_unfair_lock_unlock(registryLock)
+
+        pthread_setspecific(threadKey, Unmanaged.passUnretained(buffer).toOpaque())
+
+        return buffer
+    }
+
+    // A shared buffer can be recycled by every thread using it, it is only listed once
+    private static func recycle(_ buffer: ThreadBuffer) {
+        os_unfair_lock_lock(registryLock)
+        if !freeBuffers.contains(where: { $0 === buffer }) {
+            freeBuffers.append(buffer)
+        }
+        os_unfair_lock_unlock(registryLock)
+    }
+
+    static func all() -> [ThreadBuffer] {
+        os_unfair_lock_lock(registryLock)
+        defer { os_unfair_lock_unlock(registryLock) }
+
+        return buffers
+    }
+
+    private static func makeLock() -> UnsafeMutablePointer<os_unfair_lock> {
+        let lock = UnsafeMutablePointer<os_unfair_lock>.allocate(capacity: 1)
+        lock.initialize(to: os_unfair_lock())
+        return lock
+    }
+
+    private init(threadIndex: Int, threadName: String) {
+        self.threadIndex = threadIndex
+        self.threadName = threadName
+        spans.reserveCapacity(Trace.bufferCapacity)
+    }
+
+    deinit {
+        lock.deinitialize(count: 1)
+        lock.deallocate()
+    }
+
+    func record(_ name: StaticString, startTime: TimeInterval, endTime: TimeInterval) {
+        let span = Span(name: name, startTime: startTime, duration: endTime - startTime)
+
+        os_unfair_lock_lock(lock)
+        if spans.count < Trace.bufferCapacity {
+            spans.append(span)
+        } else {
+            spans[nextSpan] = span
+        }
+        nextSpan = (nextSpan + 1) % Trace.bufferCapacity
+
+        // A one character name is stored as its scalar rather than a pointer
+        let key = name.hasPointerRepresentation ? UInt(bitPattern: name.utf8Start) : UInt(name.unicodeScalar.value)
+        var index = 0
+        while index < counterKeys.count && counterKeys[index] != key {
+            index += 1
+        }
+        if index == counterKeys.count {
+            counterKeys.append(key)
+            counterNames.append(name)
+            counters.append(Trace.Counter())
+        }
+        counters[index].calls += 1
+        counters[index].totalDuration += span.duration
+        counters[index].maxDuration = max(counters[index].maxDuration, span.duration)
+        os_unfair_lock_unlock(lock)
+    }
+
+    // Names are only turned into strings here; equal names from different literals are merged
+    func snapshot() -> (spans: [Span], counters: [String: Trace.Counter]) {
+        os_unfair_lock_lock(lock)
+        let spans = self.spans, counterNames = self.counterNames, counters = self.counters
+        os_unfair_lock_unlock(lock)
+
+        var countersByName: [String: Trace.Counter] = [:]
+        for (name, counter) in zip(counterNames, counters) {
+            var total = countersByName[name.description, default: Trace.Counter()]
+            total.calls += counter.calls
+            total.totalDuration += counter.totalDuration
+            total.maxDuration = max(total.maxDuration, counter.maxDuration)
+            countersByName[name.description] = total
+        }
+
+        return (spans, countersByName)
+    }
+}
+#endif
@@ -0,0 +1,280 @@
+//
+//  IndoorParticleFilter.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import Accelerate
+
+// Particle filter that snaps raw location fixes to the walkable venue geometry.
+// Particles moving from one unit into another without passing an opening are penalized,
+// and particles only change floor while standing in a stairs, escalator or elevator unit.
+// The particle count is fixed, so every fix costs the same amount of work. Weighing runs on vDSP over the
+// parallel arrays; moving the particles stays a scalar loop, as it is bound by the polygon and opening tests.
+final class IndoorParticleFilter {
+    struct Estimate {
+        let mapPoint: MKMapPoint
+        let ordinalValue: Int
+        let accuracy: CLLocationDistance
+    }
+
+    var walkingSpeed = 1.4 // meters per second
+    var wallCrossingPenalty = 0.05
+    var outsideUnitsPenalty = 0.2
+    var otherFloorPenalty = 0.1
+    var floorChangeRate = 0.2 // per second spent in a vertical connector
+
+    private let geometry: VenueGeometry
+    private let particleCount: Int
+
+    // Particle state, stored as parallel arrays
+    private var xs: [Double]
+    private var ys: [Double]
+    private var ordinals: [Int]
+    private var unitIndices: [Int] // -1 when outside any walkable unit
+    private var weights: [Double]
+    private var likelihoods: [Double] // scratch space for weighing
+    private var scratch: [Double]
+
+    private var adjacentOrdinals: [Int: [Int]] = [:]
+    private var generator: SplitMix64
+    private var lastTimestamp: Date?
+
+    init(geometry: VenueGeometry, particleCount: Int = 256, seed: UInt64 = 1) {
+        self.geometry = geometry
+        self.particleCount = particleCount
+        self.xs = Array(repeating: 0, count: particleCount)
+        self.ys = Array(repeating: 0, count: particleCount)
+        self.ordinals = Array(repeating: 0, count: particleCount)
+        self.unitIndices = Array(repeating: -1, count: particleCount)
+        self.weights = Array(repeating: 1 / Double(particleCount), count: particleCount)
+        self.likelihoods = Array(repeating: 0, count: particleCount)
+        self.scratch = Array(repeating: 0, count: particleCount)
+        self.generator = SplitMix64(seed: seed)
+
+        let ordinalValues = geometry.ordinalValues
+        for (index, ordinalValue) in ordinalValues.enumerated() {
+            adjacentOrdinals[ordinalValue] = [index - 1, index + 1].filter { ordinalValues.indices.contains($0) }.map { ordinalValues[$0] }
+        }
+    }
+
+    func reset() {
+        lastTimestamp = nil
+    }
+
+    // Feeds a fix to the filter. `ordinalValue` is the floor reported with the fix, if any,
+    // `fallbackOrdinalValue` is used to place particles when the filter starts from scratch.
+    func update(with mapPoint: MKMapPoint, accuracy: CLLocationDistance, ordinalValue: Int?,
+                fallbackOrdinalValue: Int, timestamp: Date) -> Estimate {
+        let sigma = max(accuracy, 3) * geometry.mapPointsPerMeter
+
+        if let lastTimestamp = lastTimestamp {
+            predict(timeInterval: min(max(timestamp.timeIntervalSince(lastTimestamp), 0.05), 5))
+        } else {
+            scatter(around: mapPoint, sigma: sigma, ordinalValue: ordinalValue ?? fallbackOrdinalValue)
+        }
+        lastTimestamp = timestamp
+
+        if !weigh(against: mapPoint, sigma: sigma, ordinalValue: ordinalValue) {
+            // Every particle disagrees with the fix, start over around it
+            scatter(around: mapPoint, sigma: sigma, ordinalValue: ordinalValue ?? fallbackOrdinalValue)
+            _ = weigh(against: mapPoint, sigma: sigma, ordinalValue: ordinalValue)
+        }
+
+        let estimate = makeEstimate()
+
+        var sumOfSquares = 0.0
+        vDSP_svesqD(weights, 1, &sumOfSquares, vDSP_Length(particleCount))
+        let effectiveSampleSize = 1 / sumOfSquares
+        if effectiveSampleSize < Double(particleCount) / 2 {
+            resample()
+        }
+
+        return estimate
+    }
+
+    private func scatter(around mapPoint: MKMapPoint, sigma: Double, ordinalValue: Int) {
+        for i in 0..<particleCount {
+            xs[i] = mapPoint.x + gaussian() * sigma
+            ys[i] = mapPoint.y + gaussian() * sigma
+            ordinals[i] = ordinalValue
+            unitIndices[i] = walkableUnitIndex(containing: MKMapPoint(x: xs[i], y: ys[i]), ordinalValue: ordinalValue, hint: nil)
+            weights[i] = 1 / Double(particleCount)
+        }
+    }
+
+    private func predict(timeInterval: TimeInterval) {
+        let step = walkingSpeed * timeInterval * geometry.mapPointsPerMeter
+        let floorChangeProbability = floorChangeRate * timeInterval
+
+        for i in 0..<particleCount {
+            let start = MKMapPoint(x: xs[i], y: ys[i])
+            let end = MKMapPoint(x: start.x + gaussian() * step, y: start.y + gaussian() * step)
+            let previousUnitIndex = unitIndices[i]
+            var unitIndex = walkableUnitIndex(containing: end, ordinalValue: ordinals[i],
+                                              hint: previousUnitIndex >= 0 ? previousUnitIndex : nil)
+
+            if unitIndex < 0 {
+                weights[i] *= outsideUnitsPenalty
+            } else if previousUnitIndex >= 0, unitIndex != previousUnitIndex,
+                      !geometry.crossesOpening(from: start, to: end, ordinalValue: ordinals[i]) {
+                weights[i] *= wallCrossingPenalty
+            }
+
+            if unitIndex >= 0, geometry.units[unitIndex].isVerticalConnector,
+               Double.random(in: 0..<1, using: &generator) < floorChangeProbability,
+               let targetOrdinal = adjacentOrdinals[ordinals[i]]?.randomElement(using: &generator) {
+                let targetUnitIndex = walkableUnitIndex(containing: end, ordinalValue: targetOrdinal, hint: nil)
+                if targetUnitIndex >= 0, geometry.units[targetUnitIndex].isVerticalConnector {
+                    ordinals[i] = targetOrdinal
+                    unitIndex = targetUnitIndex
+                }
+            }
+
+            xs[i] = end.x
+            ys[i] = end.y
+            unitIndices[i] = unitIndex
+        }
+    }
+
+    // Returns `false` when the weights collapsed to zero
+    private func weigh(against mapPoint: MKMapPoint, sigma: Double, ordinalValue: Int?) -> Bool {
+        let length = vDSP_Length(particleCount)
+        var negativeX = -mapPoint.x, negativeY = -mapPoint.y
+        var scale = -1 / (2 * sigma * sigma)
+        var count = Int32(particleCount)
+
+        // exp(((x - px)^2 + (y - py)^2) * scale) for all particles
+        likelihoods.withUnsafeMutableBufferPointer { likelihoods in
+            scratch.withUnsafeMutableBufferPointer { scratch in
+                let l = likelihoods.baseAddress!, s = scratch.baseAddress!
+
+                vDSP_vsaddD(xs, 1, &negativeX, l, 1, length)
+                vDSP_vsqD(l, 1, l, 1, length)
+                vDSP_vsaddD(ys, 1, &negativeY, s, 1, length)
+                vDSP_vsqD(s, 1, s, 1, length)
+                vDSP_vaddD(l, 1, s, 1, l, 1, length)
+                vDSP_vsmulD(l, 1, &scale, l, 1, length)
+                vvexp(l, l, &count)
+            }
+        }
+
+        var total = 0.0
+        let otherFloorPenalty = self.otherFloorPenalty
+
+        weights.withUnsafeMutableBufferPointer { weights in
+            let w = weights.baseAddress!
+
+            vDSP_vmulD(w, 1, likelihoods, 1, w, 1, length)
+            if let ordinalValue = ordinalValue {
+                for i in 0..<particleCount where ordinals[i] != ordinalValue {
+                    w[i] *= otherFloorPenalty
+                }
+            }
+
+            vDSP_sveD(w, 1, &total, length)
+            if total > .leastNormalMagnitude {
+                vDSP_vsdivD(w, 1, &total, w, 1, length)
+            }
+        }
+
+        return total > .leastNormalMagnitude
+    }
+
+    private func makeEstimate() -> Estimate {
+        var weightsByOrdinal: [Int: Double] = [:]
+        for i in 0..<particleCount {
+            weightsByOrdinal[ordinals[i], default: 0] += weights[i]
+        }
+
+        let ordinalValue = weightsByOrdinal.max { $0.value < $1.value }?.key ?? ordinals[0]
+
+        // Weights too small to add up count the particles of the floor equally
+        let floorWeight = weightsByOrdinal[ordinalValue] ?? 0
+        func weight(_ i: Int) -> Double {
+            return floorWeight > .leastNormalMagnitude ? weights[i] : 1
+        }
+
+        var total = 0.0, x = 0.0, y = 0.0
+        for i in 0..<particleCount where ordinals[i] == ordinalValue {
+            total += weight(i)
+            x += weight(i) * xs[i]
+            y += weight(i) * ys[i]
+        }
+        x /= total
+        y /= total
+
+        var variance = 0.0
+        for i in 0..<particleCount where ordinals[i] == ordinalValue {
+            variance += weight(i) * ((xs[i] - x) * (xs[i] - x) + (ys[i] - y) * (ys[i] - y))
+        }
+
+        let accuracy = max(sqrt(variance / total) / geometry.mapPointsPerMeter, 1)
+
+        return Estimate(mapPoint: MKMapPoint(x: x, y: y), ordinalValue: ordinalValue, accuracy: accuracy)
+    }
+
+    // Systematic resampling
+    private func resample() {
+        let step = 1 / Double(particleCount)
+        var threshold = Double.random(in: 0..<step, using: &generator)
+        var cumulative = weights[0]
+        var source = 0
+
+        let xs = self.xs, ys = self.ys, ordinals = self.ordinals, unitIndices = self.unitIndices
+
+        for i in 0..<particleCount {
+            while threshold > cumulative && source < particleCount - 1 {
+                source += 1
+                cumulative += weights[source]
+            }
+
+            self.xs[i] = xs[source]
+            self.ys[i] = ys[source]
+            self.ordinals[i] = ordinals[source]
+            self.unitIndices[i] = unitIndices[source]
+            threshold += step
+        }
+
+        for i in 0..<particleCount {
+            weights[i] = step
+        }
+    }
+
+    private func walkableUnitIndex(containing point: MKMapPoint, ordinalValue: Int, hint: Int?) -> Int {
+        // Most particles that leave the level footprint are rejected here without any polygon test
+        guard geometry.isInsideLevel(point, ordinalValue: ordinalValue),
+              let unitIndex = geometry.unitIndex(containing: point, ordinalValue: ordinalValue, hint: hint),
+              geometry.units[unitIndex].isWalkable else { return -1 }
+
+        return unitIndex
+    }
+
+    // Box-Muller transform
+    private func gaussian() -> Double {
+        let u = Double.random(in: .leastNonzeroMagnitude..<1, using: &generator)
+        let v = Double.random(in: 0..<1, using: &generator)
+
+        return sqrt(-2 * log(u)) * cos(2 * .pi * v)
+    }
+}
+
+// Small seedable generator, so replayed fixes produce the same filtered track
+struct SplitMix64: RandomNumberGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+
+        return z ^ (z >> 31)
+    }
+}
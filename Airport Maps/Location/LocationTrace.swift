@@ -0,0 +1,252 @@
+//
+//  LocationTrace.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import Foundation
+import CoreLocation
+
+// Compact binary log of location and heading updates.
+// The file starts with "AMLT" and a UInt16 version, followed by records made of a kind byte
+// and a Float64 timestamp (seconds since the reference date), all values little-endian.
+// Location records add latitude and longitude as Float64, altitude, horizontal accuracy,
+// vertical accuracy, course and speed as Float32 and the floor level as Int16.
+// Heading records add magnetic heading, true heading and accuracy as Float32.
+struct LocationTrace {
+    enum Event {
+        case location(CLLocation)
+        case heading(CLHeading)
+
+        var timestamp: Date {
+            switch self {
+            case .location(let location):
+                return location.timestamp
+            case .heading(let heading):
+                return heading.timestamp
+            }
+        }
+    }
+
+    fileprivate static let magic = Data("AMLT".utf8)
+    fileprivate static let version: UInt16 = 1
+    fileprivate static let locationKind: UInt8 = 1
+    fileprivate static let headingKind: UInt8 = 2
+    fileprivate static let noFloorLevel = Int16.min
+
+    private(set) var events: [Event] = []
+
+    init?(contentsOf url: URL) {
+        guard let data = try? Data(contentsOf: url), data.prefix(4) == LocationTrace.magic else { return nil }
+
+        var reader = ByteReader(data: data, offset: 4)
+        guard let version: UInt16 = reader.read(), version == LocationTrace.version else { return nil }
+
+        while let kind: UInt8 = reader.read(), let timestamp = reader.readDouble() {
+            let date = Date(timeIntervalSinceReferenceDate: timestamp)
+
+            switch kind {
+            case LocationTrace.locationKind:
+                guard let latitude = reader.readDouble(), let longitude = reader.readDouble(),
+                      let altitude = reader.readFloat(), let horizontalAccuracy = reader.readFloat(),
+                      let verticalAccuracy = reader.readFloat(), let course = reader.readFloat(),
+                      let speed = reader.readFloat(), let level: Int16 = reader.read() else { return nil }
+
+                events.append(.location(IndoorLocation(coordinate: CLLocationCoordinate2D(latitude: latitude, longitude: longitude),
+                                                       altitude: CLLocationDistance(altitude),
+                                                       horizontalAccuracy: CLLocationAccuracy(horizontalAccuracy),
+                                                       verticalAccuracy: CLLocationAccuracy(verticalAccuracy),
+                                                       course: CLLocationDirection(course),
+                                                       speed: CLLocationSpeed(speed),
+                                                       timestamp: date,
+                                                       floorLevel: level == LocationTrace.noFloorLevel ? nil : Int(level))))
+
+            case LocationTrace.headingKind:
+                guard let magneticHeading = reader.readFloat(), let trueHeading = reader.readFloat(),
+                      let headingAccuracy = reader.readFloat() else { return nil }
+
+                events.append(.heading(ReplayedHeading(magneticHeading: CLLocationDirection(magneticHeading),
+                                                       trueHeading: CLLocationDirection(trueHeading),
+                                                       headingAccuracy: CLLocationDirection(headingAccuracy),
+                                                       timestamp: date)))
+
+            default:
+                return nil
+            }
+        }
+    }
+}
+
+final class LocationTraceWriter {
+    private let fileHandle: FileHandle
+    private var buffer = Data()
+    private var isClosed = false
+
+    init?(url: URL) {
+        guard FileManager.default.createFile(atPath: url.path, contents: nil),
+              let fileHandle = try? FileHandle(forWritingTo: url) else { return nil }
+
+        self.fileHandle = fileHandle
+
+        buffer.append(LocationTrace.magic)
+        append(LocationTrace.version)
+    }
+
+    deinit {
+        close()
+    }
+
+    func append(_ location: CLLocation) {
+        append(LocationTrace.locationKind)
+        append(location.timestamp.timeIntervalSinceReferenceDate.bitPattern)
+        append(location.coordinate.latitude.bitPattern)
+        append(location.coordinate.longitude.bitPattern)
+        append(Float(location.altitude).bitPattern)
+        append(Float(location.horizontalAccuracy).bitPattern)
+        append(Float(location.verticalAccuracy).bitPattern)
+        append(Float(location.course).bitPattern)
+        append(Float(location.speed).bitPattern)
+        append(location.floor.map { Int16(clamping: $0.level) } ?? LocationTrace.noFloorLevel)
+        flushIfNeeded()
+    }
+
+    func append(_ heading: CLHeading) {
+        append(LocationTrace.headingKind)
+        append(heading.timestamp.timeIntervalSinceReferenceDate.bitPattern)
+        append(Float(heading.magneticHeading).bitPattern)
+        append(Float(heading.trueHeading).bitPattern)
+        append(Float(heading.headingAccuracy).bitPattern)
+        flushIfNeeded()
+    }
+
+    func flush() {
+        guard !isClosed, !buffer.isEmpty else { return }
+
+        fileHandle.write(buffer)
+        buffer.removeAll(keepingCapacity: true)
+    }
+
+    func close() {
+        guard !isClosed else { return }
+
+        flush()
+        fileHandle.closeFile()
+        isClosed = true
+    }
+
+    private func append<T: FixedWidthInteger>(_ value: T) {
+        withUnsafeBytes(of: value.littleEndian) { buffer.append(contentsOf: $0) }
+    }
+
+    private func flushIfNeeded() {
+        if buffer.count >= 4096 {
+            flush()
+        }
+    }
+}
+
+private struct ByteReader {
+    let data: Data
+    var offset: Int
+
+    mutating func read<T: FixedWidthInteger>() -> T? {
+        let size = MemoryLayout<T>.size
+        guard offset + size <= data.count else { return nil }
+
+        var value: T = 0
+        for index in 0..<size {
+            value |= T(truncatingIfNeeded: data[data.startIndex + offset + index]) << (index * 8)
+        }
+        offset += size
+
+        return value
+    }
+
+    mutating func readDouble() -> Double? {
+        guard let bitPattern: UInt64 = read() else { return nil }
+
+        return Double(bitPattern: bitPattern)
+    }
+
+    mutating func readFloat() -> Float? {
+        guard let bitPattern: UInt32 = read() else { return nil }
+
+        return Float(bitPattern: bitPattern)
+    }
+}
+
+// Core Location offers no initializers for floors and headings, replayed and map matched values use these subclasses
+
+final class IndoorFloor: CLFloor {
+    private let fixedLevel: Int
+
+    init(level: Int) {
+        fixedLevel = level
+        super.init()
+    }
+
+    required init?(coder: NSCoder) {
+        return nil
+    }
+
+    override var level: Int {
+        return fixedLevel
+    }
+}
+
+final class IndoorLocation: CLLocation {
+    private let fixedFloor: CLFloor?
+
+    init(coordinate: CLLocationCoordinate2D, altitude: CLLocationDistance, horizontalAccuracy: CLLocationAccuracy,
+         verticalAccuracy: CLLocationAccuracy, course: CLLocationDirection, speed: CLLocationSpeed,
+         timestamp: Date, floorLevel: Int?) {
+        fixedFloor = floorLevel.map(IndoorFloor.init(level:))
+        super.init(coordinate: coordinate, altitude: altitude, horizontalAccuracy: horizontalAccuracy,
+                   verticalAccuracy: verticalAccuracy, course: course, speed: speed, timestamp: timestamp)
+    }
+
+    required init?(coder: NSCoder) {
+        return nil
+    }
+
+    override var floor: CLFloor? {
+        return fixedFloor
+    }
+}
+
+private final class ReplayedHeading: CLHeading {
+    private let replayedMagneticHeading: CLLocationDirection
+    private let replayedTrueHeading: CLLocationDirection
+    private let replayedHeadingAccuracy: CLLocationDirection
+    private let replayedTimestamp: Date
+
+    init(magneticHeading: CLLocationDirection, trueHeading: CLLocationDirection,
+         headingAccuracy: CLLocationDirection, timestamp: Date) {
+        replayedMagneticHeading = magneticHeading
+        replayedTrueHeading = trueHeading
+        replayedHeadingAccuracy = headingAccuracy
+        replayedTimestamp = timestamp
+        super.init()
+    }
+
+    required init?(coder: NSCoder) {
+        return nil
+    }
+
+    override var magneticHeading: CLLocationDirection {
+        return replayedMagneticHeading
+    }
+
+    override var trueHeading: CLLocationDirection {
+        return replayedTrueHeading
+    }
+
+    override var headingAccuracy: CLLocationDirection {
+        return replayedHeadingAccuracy
+    }
+
+    override var timestamp: Date {
+        return replayedTimestamp
+    }
+}
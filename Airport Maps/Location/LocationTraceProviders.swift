@@ -0,0 +1,149 @@
+//
+//  LocationTraceProviders.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import QuartzCore
+import CoreLocation
+import os.log
+
+// Map-matching provider that also writes the raw Core Location updates to a LocationTrace file
+final class LocationTraceRecordingProvider: MapMatchingLocationProvider {
+    private let writer: LocationTraceWriter
+
+    init?(traceURL: URL, venueGeometry: VenueGeometry, fallbackOrdinalValue: Int) {
+        guard let writer = LocationTraceWriter(url: traceURL) else { return nil }
+
+        self.writer = writer
+
+        super.init(venueGeometry: venueGeometry, fallbackOrdinalValue: fallbackOrdinalValue)
+    }
+
+    override func updateLocation(with location: CLLocation?) {
+        if let location = location {
+            writer.append(location)
+        }
+
+        super.updateLocation(with: location)
+    }
+
+    override func updateHeading(with heading: CLHeading?) {
+        if let heading = heading {
+            writer.append(heading)
+        }
+
+        super.updateHeading(with: heading)
+    }
+
+    override func stop() {
+        super.stop()
+
+        writer.flush()
+    }
+}
+
+// Map-matching provider that feeds a recorded LocationTrace to the manager instead of Core Location.
+// The replayed updates carry their recorded timestamps, so the outcome does not depend on the wall clock.
+// By default the events are replayed back to back, `isRealTime` paces them as they were recorded.
+final class LocationTraceReplayProvider: MapMatchingLocationProvider {
+    struct Report {
+        let updateCount: Int
+        let medianLatency: TimeInterval
+        let p90Latency: TimeInterval
+        let p99Latency: TimeInterval
+        let maximumLatency: TimeInterval
+    }
+
+    var isRealTime = false
+
+    // Called on the main queue once the whole trace has been replayed
+    var completion: ((Report) -> Void)?
+
+    private let trace: LocationTrace
+    private var nextEventIndex = 0
+    private var isReplaying = false
+    // Bumped by every start and stop, events scheduled by an earlier replay are dropped
+    private var replayGeneration = 0
+    private var latencies: [TimeInterval] = []
+
+    init(trace: LocationTrace, venueGeometry: VenueGeometry, fallbackOrdinalValue: Int) {
+        self.trace = trace
+
+        super.init(venueGeometry: venueGeometry, fallbackOrdinalValue: fallbackOrdinalValue)
+    }
+
+    override func start() {
+        guard !isReplaying else { return }
+
+        isReplaying = true
+        replayGeneration += 1
+        nextEventIndex = 0
+        latencies = []
+        latencies.reserveCapacity(trace.events.count)
+
+        scheduleNextEvent()
+    }
+
+    override func stop() {
+        isReplaying = false
+        replayGeneration += 1
+    }
+
+    private func scheduleNextEvent() {
+        guard nextEventIndex < trace.events.count else {
+            finish()
+            return
+        }
+
+        var delay: TimeInterval = 0
+        if isRealTime, nextEventIndex > 0 {
+            delay = max(trace.events[nextEventIndex].timestamp.timeIntervalSince(trace.events[nextEventIndex - 1].timestamp), 0)
+        }
+
+        let generation = replayGeneration
+        DispatchQueue.main.asyncAfter(deadline: .now() + delay) { [weak self] in
+            self?.replayNextEvent(generation: generation)
+        }
+    }
+
+    private func replayNextEvent(generation: Int) {
+        guard isReplaying, generation == replayGeneration, nextEventIndex < trace.events.count else { return }
+
+        let event = trace.events[nextEventIndex]
+        nextEventIndex += 1
+
+        let startTime = CACurrentMediaTime()
+        switch event {
+        case .location(let location):
+            updateLocation(with: location)
+        case .heading(let heading):
+            updateHeading(with: heading)
+        }
+        latencies.append(CACurrentMediaTime() - startTime)
+
+        scheduleNextEvent()
+    }
+
+    private func finish() {
+        isReplaying = false
+
+        let sortedLatencies = latencies.sorted()
+        func percentile(_ fraction: Double) -> TimeInterval {
+            guard !sortedLatencies.isEmpty else { return 0 }
+
+            return sortedLatencies[Int(Double(sortedLatencies.count - 1) * fraction)]
+        }
+
+        let report = Report(updateCount: sortedLatencies.count, medianLatency: percentile(0.5),
+                            p90Latency: percentile(0.9), p99Latency: percentile(0.99),
+                            maximumLatency: sortedLatencies.last ?? 0)
+
+        os_log("Replayed %ld updates, latency p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms", type: .info,
+               report.updateCount, report.medianLatency * 1000, report.p90Latency * 1000,
+               report.p99Latency * 1000, report.maximumLatency * 1000)
+
+        completion?(report)
+    }
+}
@@ -0,0 +1,59 @@
+//
+//  MapMatchingLocationProvider.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import CoreLocation
+
+// Core Location provider that runs every fix inside the venue through an
+// IndoorParticleFilter before handing it to the PC_IndoorMapManager.
+// Fixes outside the venue are passed on untouched and restart the filter.
+class MapMatchingLocationProvider: PC_IndoorMapCoreLocationProvider {
+    private let venueGeometry: VenueGeometry
+    private let particleFilter: IndoorParticleFilter
+
+    // Floor used to start the filter when fixes carry no floor information
+    var fallbackOrdinalValue: Int
+
+    private(set) var estimatedOrdinalValue: Int?
+
+    init(venueGeometry: VenueGeometry, fallbackOrdinalValue: Int) {
+        self.venueGeometry = venueGeometry
+        self.particleFilter = IndoorParticleFilter(geometry: venueGeometry)
+        self.fallbackOrdinalValue = fallbackOrdinalValue
+
+        super.init()
+    }
+
+    override func updateLocation(with location: CLLocation?) {
+        guard let location = location, location.horizontalAccuracy >= 0,
+              venueGeometry.isInsideVenue(MKMapPoint(location.coordinate)) else {
+            particleFilter.reset()
+            estimatedOrdinalValue = nil
+            super.updateLocation(with: location)
+            return
+        }
+
+        let estimate = Trace.span("particleFilter") {
+            particleFilter.update(with: MKMapPoint(location.coordinate),
+                                  accuracy: location.horizontalAccuracy,
+                                  ordinalValue: location.floor?.level,
+                                  fallbackOrdinalValue: estimatedOrdinalValue ?? fallbackOrdinalValue,
+                                  timestamp: location.timestamp)
+        }
+        estimatedOrdinalValue = estimate.ordinalValue
+
+        // The estimated floor travels with the fix, so the manager follows the filter's floor as well
+        super.updateLocation(with: IndoorLocation(coordinate: estimate.mapPoint.coordinate,
+                                                  altitude: location.altitude,
+                                                  horizontalAccuracy: estimate.accuracy,
+                                                  verticalAccuracy: location.verticalAccuracy,
+                                                  course: location.course,
+                                                  speed: location.speed,
+                                                  timestamp: location.timestamp,
+                                                  floorLevel: estimate.ordinalValue))
+    }
+}
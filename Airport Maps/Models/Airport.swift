@@ -78,5 +78,18 @@ public struct Airport: Codable, Hashable, Identifiable {
     public func ordinalNames() -> [String] {
         return self.airportOrdinalNames
     }
+
+    // The ordinal names run from the lowest floor up to the maximum ordinal, so basements get negative ordinals
+    public func ordinalValue(forNameAt index: Int) -> Int {
+        let maximumOrdinal = Int(self.airportMaximumOrdinal) ?? self.airportOrdinalNames.count - 1
+
+        return maximumOrdinal - (self.airportOrdinalNames.count - 1) + index
+    }
+
+    public func ordinalName(for ordinalValue: Int) -> String? {
+        let index = ordinalValue - self.ordinalValue(forNameAt: 0)
+
+        return self.airportOrdinalNames.indices.contains(index) ? self.airportOrdinalNames[index] : nil
+    }
 }
 
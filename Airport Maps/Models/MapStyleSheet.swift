@@ -0,0 +1,241 @@
+//
+//  MapStyleSheet.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import UIKit
+
+// Declarative feature styling as stored in Maps/MapStyleSheet.json.
+// Rules are matched in order, the first matching rule wins. A matched rule without
+// a renderer hides the feature, as does a feature that matches no rule at all.
+// A null entry in `categories` matches features without a CATEGORY, an empty string only an empty one.
+public struct MapStyleSheet: Codable {
+    struct Renderer: Codable {
+        var strokeColor: String?
+        var strokeWidth: CGFloat?
+        var fillColor: String?
+    }
+
+    struct Rule: Codable {
+        var layer: String
+        var categories: [String?]?
+        var categoryContains: [String]?
+        var properties: [String: String]?
+        var minZoomLevel: CGFloat?
+        var maxZoomLevel: CGFloat?
+        var renderer: String?
+    }
+
+    var renderers: [String: Renderer]
+    var rules: [Rule]
+}
+
+// The compiled form of a MapStyleSheet. Renderers are created once and shared by all
+// overlays using them, so they must not be modified after compilation.
+// Resolutions are cached per layer and category, and per feature by its global index, so a feature
+// seen before is styled without reading its properties again. Access from the main thread only.
+public final class MapStyle {
+    private struct Style {
+        let renderer: PC_IndoorMapRenderer?
+        let minZoomLevel: CGFloat?
+        let maxZoomLevel: CGFloat?
+    }
+
+    private struct CompiledRule {
+        let categories: Set<String>?
+        let matchesMissingCategory: Bool
+        let categoryContains: [String]?
+        let properties: [String: String]?
+        let style: Style
+
+        func matches(category: String?) -> Bool {
+            guard let category = category else {
+                return (categories == nil || matchesMissingCategory) && categoryContains == nil
+            }
+            if let categories = categories, !categories.contains(category) {
+                return false
+            }
+            if let categoryContains = categoryContains, !categoryContains.contains(where: { category.contains($0) }) {
+                return false
+            }
+            return true
+        }
+
+        func matches(feature: PC_IndoorMapFeature) -> Bool {
+            guard let properties = properties else { return true }
+
+            return properties.allSatisfy { feature.string(forKey: $0.key) == $0.value }
+        }
+    }
+
+    private enum Resolution {
+        case style(Style?)
+        case conditional([CompiledRule])
+    }
+
+    private struct LookupKey: Hashable {
+        let layerType: Int
+        let category: Int32 // in `categories`, -1 without a category
+    }
+
+    private static let layerTypes: [String: PC_IndoorMapLayerType] = [
+        "levels": .levels, "points": .points, "units": .units, "openings": .openings,
+        "occupants": .occupants, "buildings": .buildings, "fixtures": .fixtures, "zones": .zones,
+        "venue": .venue, "anchors": .anchors, "details": .details, "sections": .sections,
+        "footprints": .footprints, "kiosks": .kiosks
+    ]
+
+    private var rulesByLayerType: [Int: [CompiledRule]] = [:]
+    private var resolutions: [Resolution] = []
+    private var resolutionIndices: [LookupKey: Int32] = [:]
+    private var featureResolutionIndices: [Int32] = [] // by global index, -1 when not seen yet
+    private let categories = StringInterner()
+
+    // Number of reads of allocating feature accessors, categoryName and string(forKey:)
+    private(set) var propertyReadCount = 0
+
+    public init(styleSheet: MapStyleSheet) {
+        var renderers: [String: PC_IndoorMapRenderer] = [:]
+
+        for (name, definition) in styleSheet.renderers {
+            let renderer = PC_IndoorMapRenderer()
+            renderer.strokeColor = definition.strokeColor.map(MapStyle.color(hexString:))
+            renderer.fillColor = definition.fillColor.map(MapStyle.color(hexString:))
+            if let strokeWidth = definition.strokeWidth {
+                renderer.strokeWidth = strokeWidth
+            }
+            renderers[name] = renderer
+        }
+
+        for rule in styleSheet.rules {
+            guard let layerType = MapStyle.layerTypes[rule.layer] else {
+                fatalError("Unknown layer \(rule.layer) in style sheet.")
+            }
+
+            var renderer: PC_IndoorMapRenderer? = nil
+            if let rendererName = rule.renderer {
+                guard let namedRenderer = renderers[rendererName] else {
+                    fatalError("Unknown renderer \(rendererName) in style sheet.")
+                }
+                renderer = namedRenderer
+            }
+
+            let style = Style(renderer: renderer, minZoomLevel: rule.minZoomLevel, maxZoomLevel: rule.maxZoomLevel)
+            let compiledRule = CompiledRule(categories: rule.categories.map { Set($0.compactMap { $0 }) },
+                                            matchesMissingCategory: rule.categories?.contains(nil) ?? false,
+                                            categoryContains: rule.categoryContains, properties: rule.properties, style: style)
+
+            rulesByLayerType[layerType.rawValue, default: []].append(compiledRule)
+        }
+    }
+
+    public convenience init(resource: String) {
+        guard let url = Bundle.main.url(forResource: resource, withExtension: "json") else {
+            fatalError("Failed to locate file in bundle.")
+        }
+
+        guard let data = try? Data(contentsOf: url) else {
+            fatalError("Failed to load file from bundle.")
+        }
+
+        guard let styleSheet = try? JSONDecoder().decode(MapStyleSheet.self, from: data) else {
+            fatalError("Failed to decode file from bundle.")
+        }
+
+        self.init(styleSheet: styleSheet)
+    }
+
+    public func apply(to featureOverlay: PC_IndoorMapFeatureOverlay) {
+        let style = self.style(for: featureOverlay.feature)
+
+        featureOverlay.renderer = style?.renderer
+
+        if let minZoomLevel = style?.minZoomLevel {
+            featureOverlay.minZoomLevel = minZoomLevel
+        }
+        if let maxZoomLevel = style?.maxZoomLevel {
+            featureOverlay.maxZoomLevel = maxZoomLevel
+        }
+    }
+
+    func renderer(for feature: PC_IndoorMapFeature) -> PC_IndoorMapRenderer? {
+        return style(for: feature)?.renderer
+    }
+
+    private func style(for feature: PC_IndoorMapFeature) -> Style? {
+        switch resolution(for: feature) {
+        case .style(let style):
+            return style
+        case .conditional(let rules):
+            return rules.first(where: { rule in
+                propertyReadCount += rule.properties?.count ?? 0
+                return rule.matches(feature: feature)
+            })?.style
+        }
+    }
+
+    private func resolution(for feature: PC_IndoorMapFeature) -> Resolution {
+        let globalIndex = feature.globalIndex
+        if globalIndex >= 0, globalIndex < featureResolutionIndices.count, featureResolutionIndices[globalIndex] >= 0 {
+            return resolutions[Int(featureResolutionIndices[globalIndex])]
+        }
+
+        propertyReadCount += 1
+        let key = LookupKey(layerType: feature.layer.layerType.rawValue, category: feature.categoryName.map(categories.intern) ?? -1)
+
+        let index: Int32
+        if let cached = resolutionIndices[key] {
+            index = cached
+        } else {
+            index = Int32(resolutions.count)
+            resolutions.append(resolve(key))
+            resolutionIndices[key] = index
+        }
+
+        // Global indices are never reused and categories do not change after loading, see VenueDelta
+        if globalIndex >= 0 {
+            if globalIndex >= featureResolutionIndices.count {
+                featureResolutionIndices.append(contentsOf: repeatElement(-1, count: globalIndex + 1 - featureResolutionIndices.count))
+            }
+            featureResolutionIndices[globalIndex] = index
+        }
+
+        return resolutions[Int(index)]
+    }
+
+    // Narrows the layer rules down to the ones that can match the category. Property
+    // predicates are only evaluated per feature when such a rule comes first.
+    private func resolve(_ key: LookupKey) -> Resolution {
+        var candidates: [CompiledRule] = []
+        let categoryName = key.category >= 0 ? categories.string(for: key.category) : nil
+
+        for rule in rulesByLayerType[key.layerType] ?? [] where rule.matches(category: categoryName) {
+            candidates.append(rule)
+            if rule.properties == nil {
+                break
+            }
+        }
+
+        guard let first = candidates.first else { return .style(nil) }
+
+        return first.properties == nil ? .style(first.style) : .conditional(candidates)
+    }
+
+    private static func color(hexString: String) -> UIColor {
+        var hex = hexString
+        if hex.hasPrefix("#") {
+            hex.removeFirst()
+        }
+
+        guard hex.count == 6 || hex.count == 8, let value = UInt32(hex, radix: 16) else {
+            fatalError("Invalid color \(hexString) in style sheet.")
+        }
+
+        let rgba = hex.count == 6 ? value << 8 | 0xFF : value
+
+        return UIColor(red: CGFloat((rgba >> 24) & 0xFF) / 255, green: CGFloat((rgba >> 16) & 0xFF) / 255,
+                       blue: CGFloat((rgba >> 8) & 0xFF) / 255, alpha: CGFloat(rgba & 0xFF) / 255)
+    }
+}
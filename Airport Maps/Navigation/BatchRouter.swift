@@ -0,0 +1,199 @@
+//
+//  BatchRouter.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import QuartzCore
+import os.log
+
+// Answers route and walking time matrix requests given as newline delimited JSON, for offline jobs such as
+// gate to gate and gate to amenity tables. Requests are answered in parallel on all cores against one
+// VenueSnapshot; answers are written as newline delimited JSON in request order.
+// Live closures and penalties are left out, the tables describe the venue as built.
+//
+//   {"id": "d7-c4", "type": "route", "from": {"feature": "<OCCU_ID>"}, "to": {"latitude": 52.31, "longitude": 4.76, "ordinal": 1}}
+//   {"id": "gates", "type": "matrix", "origins": [...], "destinations": [...], "navigationIndices": [0, 1]}
+final class BatchRouter {
+    struct Location: Decodable {
+        let feature: String?
+        let latitude: Double?
+        let longitude: Double?
+        let ordinal: Int?
+    }
+
+    struct Request: Decodable {
+        enum Kind: String, Decodable {
+            case route, matrix
+        }
+
+        let id: String
+        let type: Kind
+        let from: Location?
+        let to: Location?
+        let origins: [Location]?
+        let destinations: [Location]?
+        let navigationIndices: [Int]?
+    }
+
+    struct Step: Encodable {
+        let ordinal: Int
+        let distance: CLLocationDistance
+        let coordinates: [[Double]] // longitude, latitude
+    }
+
+    struct Answer: Encodable {
+        let id: String
+        let navigationIndex: Int
+        var origin: Int? = nil // matrix positions
+        var destination: Int? = nil
+        var distance: CLLocationDistance? = nil
+        var time: TimeInterval? = nil
+        var steps: [Step]? = nil
+        var error: String? = nil
+    }
+
+    // Lines answered per parallel batch, answers of a batch are written before the next batch is read
+    static let batchSize = 256
+
+    private let snapshot: VenueSnapshot
+
+    init(snapshot: VenueSnapshot) {
+        self.snapshot = snapshot
+    }
+
+    // Reads requests from `inputURL` and writes the answers to `outputURL`, on a background queue
+    func answerRequests(contentsOf inputURL: URL, writingTo outputURL: URL, completion: @escaping (Bool) -> Void) {
+        DispatchQueue.global(qos: .userInitiated).async {
+            guard let input = try? String(contentsOf: inputURL, encoding: .utf8),
+                  FileManager.default.createFile(atPath: outputURL.path, contents: nil),
+                  let output = try? FileHandle(forWritingTo: outputURL) else {
+                DispatchQueue.main.async { completion(false) }
+                return
+            }
+
+            let startTime = CACurrentMediaTime()
+            let lines = input.split(whereSeparator: \.isNewline)
+            var answerCount = 0
+
+            for batchStart in stride(from: 0, to: lines.count, by: BatchRouter.batchSize) {
+                let batch = lines[batchStart..<min(batchStart + BatchRouter.batchSize, lines.count)]
+                let answers = self.answers(to: Array(batch))
+
+                for answer in answers.joined() {
+                    output.write(answer)
+                    answerCount += 1
+                }
+            }
+            output.closeFile()
+
+            os_log("Answered %ld requests with %ld routes in %.0f ms", type: .info, lines.count, answerCount,
+                   (CACurrentMediaTime() - startTime) * 1000)
+
+            DispatchQueue.main.async { completion(true) }
+        }
+    }
+
+    // The encoded answer lines of every request line, in order
+    func answers(to lines: [Substring]) -> [[Data]] {
+        var answers = [[Data]](repeating: [], count: lines.count)
+
+        answers.withUnsafeMutableBufferPointer { buffer in
+            DispatchQueue.concurrentPerform(iterations: lines.count) { index in
+                let encoder = JSONEncoder()
+                buffer[index] = answer(toLine: lines[index]).compactMap { answer in
+                    (try? encoder.encode(answer)).map { $0 + [UInt8(ascii: "\n")] }
+                }
+            }
+        }
+
+        return answers
+    }
+
+    private func answer(toLine line: Substring) -> [Answer] {
+        guard let request = try? JSONDecoder().decode(Request.self, from: Data(line.utf8)) else {
+            return [Answer(id: "", navigationIndex: 0, error: "invalid request")]
+        }
+
+        let navigationIndices = request.navigationIndices ?? [0]
+
+        switch request.type {
+        case .route:
+            return navigationIndices.map { navigationIndex in
+                answer(id: request.id, from: request.from, to: request.to, navigationIndex: navigationIndex, withSteps: true)
+            }
+        case .matrix:
+            let origins = request.origins ?? [], destinations = request.destinations ?? []
+            var answers: [Answer] = []
+
+            for navigationIndex in navigationIndices {
+                for (originIndex, origin) in origins.enumerated() {
+                    for (destinationIndex, destination) in destinations.enumerated() {
+                        var answer = self.answer(id: request.id, from: origin, to: destination, navigationIndex: navigationIndex,
+                                                 withSteps: false)
+                        answer.origin = originIndex
+                        answer.destination = destinationIndex
+                        answers.append(answer)
+                    }
+                }
+            }
+
+            return answers
+        }
+    }
+
+    private func answer(id: String, from: Location?, to: Location?, navigationIndex: Int, withSteps: Bool) -> Answer {
+        var answer = Answer(id: id, navigationIndex: navigationIndex)
+
+        guard let start = from.flatMap(resolve), let end = to.flatMap(resolve) else {
+            answer.error = "unknown location"
+            return answer
+        }
+
+        guard let route = snapshot.navigationGraph.route(from: start.mapPoint, fromOrdinalValue: start.ordinalValue, to: end.mapPoint,
+                                      toOrdinalValue: end.ordinalValue, profile: NavigationGraph.Profile(navigationIndex: navigationIndex)) else {
+            answer.error = "no route"
+            return answer
+        }
+
+        answer.distance = route.distance
+        answer.time = route.distance / NavigationGraph.walkingSpeed
+        if withSteps {
+            answer.steps = BatchRouter.steps(of: route)
+        }
+
+        return answer
+    }
+
+    private func resolve(_ location: Location) -> (mapPoint: MKMapPoint, ordinalValue: Int)? {
+        if let identifier = location.feature {
+            return snapshot.feature(withIdentifier: identifier).map { ($0.mapPoint, $0.ordinalValue) }
+        }
+        guard let latitude = location.latitude, let longitude = location.longitude, let ordinal = location.ordinal else { return nil }
+
+        return (MKMapPoint(CLLocationCoordinate2D(latitude: latitude, longitude: longitude)), ordinal)
+    }
+
+    // One step per floor the route walks on
+    private static func steps(of route: NavigationGraph.Route) -> [Step] {
+        var steps: [Step] = []
+        var runStart = 0
+        let vertices = route.vertices
+
+        for index in 1...vertices.count where index == vertices.count || vertices[index].ordinalValue != vertices[runStart].ordinalValue {
+            let run = vertices[runStart..<index]
+            let distance = zip(run, run.dropFirst()).reduce(0) { $0 + $1.0.mapPoint.distance(to: $1.1.mapPoint) }
+            let coordinates = run.map { vertex -> [Double] in
+                let coordinate = vertex.mapPoint.coordinate
+                return [coordinate.longitude, coordinate.latitude]
+            }
+
+            steps.append(Step(ordinal: vertices[runStart].ordinalValue, distance: distance, coordinates: coordinates))
+            runStart = index
+        }
+
+        return steps
+    }
+}
@@ -0,0 +1,53 @@
+//
+//  Isochrone.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import QuartzCore
+import os.log
+
+// Everything reachable within a walking time from a location, for "within 10 minutes of gate D7" overlays.
+// Reachability is per unit: a unit counts once its entrance is within the time, and so do the features in it.
+struct Isochrone {
+    let time: TimeInterval
+    let features: [PC_IndoorMapFeature]
+    let polygonsByOrdinal: [Int: [MKPolygon]]
+}
+
+extension ResidentVenue {
+    // Walks the navigation graph until the time runs out, closures and penalties of the route planner included
+    func isochrone(from location: PC_IndoorMapLocation, time: TimeInterval, navigationIndex: Int) -> Isochrone? {
+        guard let graph = navigationGraph, let geometry = geometry else { return nil }
+
+        let startTime = CACurrentMediaTime()
+        let unitDistances = graph.reachableUnits(from: location.mapPoint, ordinalValue: location.ordinalValue,
+                                                 maxDistance: time * NavigationGraph.walkingSpeed,
+                                                 profile: NavigationGraph.Profile(navigationIndex: navigationIndex),
+                                                 metric: routePlanner?.metric)
+
+        var features: [PC_IndoorMapFeature] = []
+        var polygonsByOrdinal: [Int: [MKPolygon]] = [:]
+
+        for unitIndex in unitDistances.keys {
+            let unit = geometry.units[unitIndex]
+
+            features.append(contentsOf: (featuresByUnit[unitIndex] ?? []).filter { !isFeatureRemoved($0) })
+
+            for polygon in unit.polygons {
+                guard let exterior = polygon.rings.first else { continue }
+
+                let interiors = polygon.rings.dropFirst().map { MKPolygon(points: $0, count: $0.count) }
+                polygonsByOrdinal[unit.ordinalValue, default: []].append(MKPolygon(points: exterior, count: exterior.count,
+                                                                                     interiorPolygons: interiors))
+            }
+        }
+
+        os_log("Isochrone of %.0f s reached %ld units in %.2f ms", type: .info, time, unitDistances.count,
+               (CACurrentMediaTime() - startTime) * 1000)
+
+        return Isochrone(time: time, features: features, polygonsByOrdinal: polygonsByOrdinal)
+    }
+}
@@ -0,0 +1,93 @@
+//
+//  LandmarkIndex.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+
+// Named occupants, points and openings per floor, indexed for corridor queries along route steps
+final class LandmarkIndex {
+    struct Landmark {
+        let title: String
+        let mapPoint: MKMapPoint
+        let ordinalValue: Int
+        let layerType: PC_IndoorMapLayerType
+
+        var rank: Int {
+            return LandmarkIndex.rank(of: layerType)
+        }
+    }
+
+    static let landmarkLayerTypes: Set<PC_IndoorMapLayerType> = [.occupants, .points, .openings]
+
+    // Occupants are the easiest to recognise, openings the hardest
+    static func rank(of layerType: PC_IndoorMapLayerType) -> Int {
+        switch layerType {
+        case .occupants:
+            return 0
+        case .points:
+            return 1
+        default:
+            return 2
+        }
+    }
+
+    // The title a venue delta gave the feature, else its NAME or SHORT_NAME. The manager leaves `title` to the app.
+    static func title(of feature: PC_IndoorMapFeature) -> String? {
+        if let title = feature.title, !title.isEmpty {
+            return title
+        }
+
+        return feature.nameOrShortName
+    }
+
+    let landmarks: [Landmark]
+
+    private let grids: [Int: SpatialGrid]
+
+    var byteCount: Int {
+        return landmarks.reduce(landmarks.count * MemoryLayout<Landmark>.stride) { $0 + $1.title.utf8.count }
+            + grids.values.reduce(0) { $0 + $1.byteCount }
+    }
+
+    init(features: [PC_IndoorMapFeature], limitRect: MKMapRect, mapPointsPerMeter: Double) {
+        var landmarks: [Landmark] = []
+
+        for feature in features where LandmarkIndex.landmarkLayerTypes.contains(feature.layer.layerType) {
+            guard let title = LandmarkIndex.title(of: feature), let location = feature.location else { continue }
+
+            landmarks.append(Landmark(title: title, mapPoint: location.mapPoint, ordinalValue: location.ordinalValue,
+                                      layerType: feature.layer.layerType))
+        }
+
+        var grids: [Int: SpatialGrid] = [:]
+        for ordinalValue in Set(landmarks.map { $0.ordinalValue }) {
+            let items = landmarks.indices.filter { landmarks[$0].ordinalValue == ordinalValue }
+                .map { (index: $0, rect: MKMapRect(origin: landmarks[$0].mapPoint, size: MKMapSize())) }
+            grids[ordinalValue] = SpatialGrid(bounds: limitRect, cellSize: 10 * mapPointsPerMeter, items: items)
+        }
+
+        self.landmarks = landmarks
+        self.grids = grids
+    }
+
+    // Landmarks within `corridorWidth` map points of the segment, nearest to its end first
+    func landmarks(alongSegmentFrom start: MKMapPoint, to end: MKMapPoint, ordinalValue: Int, corridorWidth: Double) -> [Int] {
+        guard let grid = grids[ordinalValue] else { return [] }
+
+        let rect = VenueGeometry.boundingRect(of: [start, end]).insetBy(dx: -corridorWidth, dy: -corridorWidth)
+        var indices = Set<Int>()
+
+        grid.forEachItem(in: rect) { index in
+            if VenueGeometry.distance(from: landmarks[index].mapPoint, toSegmentFrom: start, to: end) <= corridorWidth {
+                indices.insert(index)
+            }
+        }
+
+        return indices.sorted {
+            (landmarks[$0].rank, landmarks[$0].mapPoint.distance(to: end)) < (landmarks[$1].rank, landmarks[$1].mapPoint.distance(to: end))
+        }
+    }
+}
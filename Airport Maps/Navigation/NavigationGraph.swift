@@ -0,0 +1,446 @@
+//
+//  NavigationGraph.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+
+// Walkable graph of a venue built from its VenueGeometry, shared by all routing profiles.
+// Nodes are the openings, plus one node per stairs, escalator or elevator unit. Nodes are linked
+// when they share a unit, when they are close to each other in the open space between the units
+// of a floor, and across floors when connector units of the same kind overlap.
+// Every edge carries a small attribute mask and a profile lists the attributes it avoids,
+// so a profile is a filter applied while searching and adds nothing to the graph.
+// The graph itself never changes, closures and penalties are layered on top by a NavigationMetric.
+final class NavigationGraph {
+    struct EdgeAttributes: OptionSet, Hashable {
+        let rawValue: UInt8
+
+        static let stairs = EdgeAttributes(rawValue: 1 << 0)
+        static let escalator = EdgeAttributes(rawValue: 1 << 1)
+        static let elevator = EdgeAttributes(rawValue: 1 << 2)
+        static let staffOnly = EdgeAttributes(rawValue: 1 << 3)
+        static let securityCrossing = EdgeAttributes(rawValue: 1 << 4) // units whose category names security, none in AMS
+        static let floorChange = EdgeAttributes(rawValue: 1 << 5)
+    }
+
+    struct Profile {
+        let avoidedAttributes: EdgeAttributes
+
+        static let standard = Profile(avoidedAttributes: [.staffOnly])
+        static let stepFree = Profile(avoidedAttributes: [.stairs, .escalator, .staffOnly])
+        static let escalatorFree = Profile(avoidedAttributes: [.escalator, .staffOnly])
+        static let staff = Profile(avoidedAttributes: [])
+
+        // Matches PC_IndoorMapRouteRequest.navigationIndex, 0 is the normal and 1 the wheelchair dataset
+        init(navigationIndex: Int) {
+            switch navigationIndex {
+            case 1:
+                self = .stepFree
+            default:
+                self = .standard
+            }
+        }
+
+        init(avoidedAttributes: EdgeAttributes) {
+            self.avoidedAttributes = avoidedAttributes
+        }
+
+        func allows(_ attributes: EdgeAttributes) -> Bool {
+            return attributes.isDisjoint(with: avoidedAttributes)
+        }
+    }
+
+    struct Route {
+        let vertices: [RouteStepBuilder.Vertex]
+        let edges: [Int32]
+        let distance: CLLocationDistance // meters, penalties included
+    }
+
+    static let freeSpaceNeighbourCount = 8
+    static let floorChangeLength = 10.0 // meters added for every floor change
+    static let walkingSpeed = 1.4 // meters per second
+
+    private static let gridCellSizeInMeters = 10.0
+
+    let nodeMapPoints: [MKMapPoint]
+    let nodeOrdinals: [Int]
+
+    // Compressed adjacency: the edges of node n are edgeOffsets[n]..<edgeOffsets[n + 1]
+    private let edgeOffsets: [Int32]
+    private let edgeTargets: [Int32]
+    private let edgeLengths: [Float] // meters
+    private let edgeAttributes: [EdgeAttributes]
+    private let edgeUnits: [Int32] // the unit walked through, -1 in the open space
+
+    // The opening of every node, -1 for connector nodes
+    private let nodeOpenings: [Int32]
+
+    private let nodesByUnit: [Int: [Int32]]
+    private let freeSpaceNodesByOrdinal: [Int: [Int32]]
+    private let freeSpaceGrids: [Int: SpatialGrid] // positions in freeSpaceNodesByOrdinal
+    private let geometry: VenueGeometry
+
+    var nodeCount: Int {
+        return nodeMapPoints.count
+    }
+
+    var edgeCount: Int {
+        return edgeTargets.count
+    }
+
+    var byteCount: Int {
+        return nodeMapPoints.count * (MemoryLayout<MKMapPoint>.stride + MemoryLayout<Int>.stride + 2 * MemoryLayout<Int32>.stride)
+            + edgeTargets.count * (2 * MemoryLayout<Int32>.stride + MemoryLayout<Float>.stride + MemoryLayout<EdgeAttributes>.stride)
+            + freeSpaceGrids.values.reduce(0) { $0 + $1.byteCount }
+    }
+
+    init(geometry: VenueGeometry) {
+        var nodeMapPoints: [MKMapPoint] = []
+        var nodeOrdinals: [Int] = []
+        var nodeOpenings: [Int32] = []
+        var nodesByUnit: [Int: [Int32]] = [:]
+        var freeSpaceNodesByOrdinal: [Int: [Int32]] = [:]
+        let mapPointsPerMeter = geometry.mapPointsPerMeter
+
+        func addNode(_ mapPoint: MKMapPoint, ordinalValue: Int, openingIndex: Int = -1) -> Int32 {
+            nodeMapPoints.append(mapPoint)
+            nodeOrdinals.append(ordinalValue)
+            nodeOpenings.append(Int32(openingIndex))
+
+            return Int32(nodeMapPoints.count - 1)
+        }
+
+        // Openings: the units they connect come from the unit walls they lie on. Openings touching fewer than two
+        // units are probed half a meter to either side, for the open space of the floor or a unit drawn off the wall.
+        let adjacency = OpeningAdjacency(geometry: geometry)
+        adjacency.log()
+
+        for (openingIndex, opening) in geometry.openings.enumerated() {
+            guard let line = opening.lines.first, let a = line.first, let b = line.last else { continue }
+
+            let length = hypot(b.x - a.x, b.y - a.y)
+            guard length > 0 else { continue }
+
+            let middle = MKMapPoint(x: (a.x + b.x) / 2, y: (a.y + b.y) / 2)
+            let node = addNode(middle, ordinalValue: opening.ordinalValue, openingIndex: openingIndex)
+            let unitIndices = adjacency.unitIndices[openingIndex]
+
+            for unitIndex in unitIndices where geometry.units[unitIndex].isWalkable {
+                nodesByUnit[unitIndex, default: []].append(node)
+            }
+
+            guard unitIndices.count < 2 else { continue }
+
+            let offset = 0.5 * mapPointsPerMeter / length
+            for sign in [1.0, -1.0] {
+                let side = MKMapPoint(x: middle.x - sign * (b.y - a.y) * offset, y: middle.y + sign * (b.x - a.x) * offset)
+
+                if let unitIndex = geometry.unitIndex(containing: side, ordinalValue: opening.ordinalValue) {
+                    if !unitIndices.contains(unitIndex), geometry.units[unitIndex].isWalkable {
+                        nodesByUnit[unitIndex, default: []].append(node)
+                    }
+                } else if geometry.isInsideLevel(side, ordinalValue: opening.ordinalValue) {
+                    freeSpaceNodesByOrdinal[opening.ordinalValue, default: []].append(node)
+                }
+            }
+        }
+
+        // Connectors: a node in the middle, reachable from the open space when the unit has no openings
+        var connectorNodes: [(unitIndex: Int, node: Int32)] = []
+        for (unitIndex, unit) in geometry.units.enumerated() where unit.isVerticalConnector {
+            let node = addNode(MKMapPoint(x: unit.boundingRect.midX, y: unit.boundingRect.midY), ordinalValue: unit.ordinalValue)
+            if nodesByUnit[unitIndex] == nil {
+                freeSpaceNodesByOrdinal[unit.ordinalValue, default: []].append(node)
+            }
+            nodesByUnit[unitIndex, default: []].append(node)
+            connectorNodes.append((unitIndex, node))
+        }
+
+        var edges: [(from: Int32, to: Int32, length: Float, attributes: EdgeAttributes, unitIndex: Int32)] = []
+
+        func meters(_ a: Int32, _ b: Int32) -> Double {
+            let p = nodeMapPoints[Int(a)], q = nodeMapPoints[Int(b)]
+
+            return hypot(p.x - q.x, p.y - q.y) / mapPointsPerMeter
+        }
+
+        func addEdge(_ a: Int32, _ b: Int32, length: Double, attributes: EdgeAttributes, unitIndex: Int = -1) {
+            guard a != b else { return }
+
+            edges.append((a, b, Float(length), attributes, Int32(unitIndex)))
+            edges.append((b, a, Float(length), attributes, Int32(unitIndex)))
+        }
+
+        for (unitIndex, nodes) in nodesByUnit {
+            let attributes = NavigationGraph.attributes(of: geometry.units[unitIndex])
+
+            for i in nodes.indices {
+                for j in nodes.indices where j > i {
+                    addEdge(nodes[i], nodes[j], length: meters(nodes[i], nodes[j]), attributes: attributes, unitIndex: unitIndex)
+                }
+            }
+        }
+
+        let cellSize = NavigationGraph.gridCellSizeInMeters * mapPointsPerMeter
+        var freeSpaceGrids: [Int: SpatialGrid] = [:]
+
+        for (ordinalValue, nodes) in freeSpaceNodesByOrdinal {
+            let grid = SpatialGrid(bounds: geometry.limitRect, cellSize: cellSize,
+                                   items: nodes.indices.map { (index: $0, rect: MKMapRect(origin: nodeMapPoints[Int(nodes[$0])], size: MKMapSize())) })
+            freeSpaceGrids[ordinalValue] = grid
+            var linked = Set<Int64>()
+
+            for node in nodes {
+                let neighbours = grid.nearestItems(to: nodeMapPoints[Int(node)], count: NavigationGraph.freeSpaceNeighbourCount + 1) {
+                    meters(node, nodes[$0])
+                }.map { nodes[$0] }.filter { $0 != node }.prefix(NavigationGraph.freeSpaceNeighbourCount)
+
+                for neighbour in neighbours where linked.insert(Int64(min(node, neighbour)) << 32 | Int64(max(node, neighbour))).inserted {
+                    addEdge(node, neighbour, length: meters(node, neighbour), attributes: [])
+                }
+            }
+        }
+
+        // Overlapping connectors of the same kind on consecutive floors, found through a grid of the connectors per floor
+        let ordinalValues = geometry.ordinalValues
+        var connectorGrids: [Int: SpatialGrid] = [:]
+        for (ordinalValue, connectors) in Dictionary(grouping: connectorNodes.indices, by: { geometry.units[connectorNodes[$0].unitIndex].ordinalValue }) {
+            connectorGrids[ordinalValue] = SpatialGrid(bounds: geometry.limitRect, cellSize: cellSize,
+                                                       items: connectors.map { (index: $0, rect: geometry.units[connectorNodes[$0].unitIndex].boundingRect) })
+        }
+
+        for first in connectorNodes {
+            let firstUnit = geometry.units[first.unitIndex]
+            guard let position = ordinalValues.firstIndex(of: firstUnit.ordinalValue), position + 1 < ordinalValues.count,
+                  let grid = connectorGrids[ordinalValues[position + 1]] else { continue }
+
+            let attributes = NavigationGraph.attributes(of: firstUnit)
+            var candidates = Set<Int>()
+            grid.forEachItem(in: firstUnit.boundingRect) { candidates.insert($0) }
+
+            for second in candidates.sorted().map({ connectorNodes[$0] }) {
+                let secondUnit = geometry.units[second.unitIndex]
+                guard firstUnit.boundingRect.intersects(secondUnit.boundingRect),
+                      NavigationGraph.attributes(of: secondUnit) == attributes else { continue }
+
+                // Each direction belongs to the connector it arrives in, so closing either one stops the floor change
+                let length = Float(meters(first.node, second.node) + NavigationGraph.floorChangeLength)
+                edges.append((first.node, second.node, length, attributes.union(.floorChange), Int32(second.unitIndex)))
+                edges.append((second.node, first.node, length, attributes.union(.floorChange), Int32(first.unitIndex)))
+            }
+        }
+
+        edges.sort { $0.from < $1.from }
+
+        var edgeOffsets = [Int32](repeating: 0, count: nodeMapPoints.count + 1)
+        for edge in edges {
+            edgeOffsets[Int(edge.from) + 1] += 1
+        }
+        for index in 1..<edgeOffsets.count {
+            edgeOffsets[index] += edgeOffsets[index - 1]
+        }
+
+        self.nodeMapPoints = nodeMapPoints
+        self.nodeOrdinals = nodeOrdinals
+        self.edgeOffsets = edgeOffsets
+        self.edgeTargets = edges.map { $0.to }
+        self.edgeLengths = edges.map { $0.length }
+        self.edgeAttributes = edges.map { $0.attributes }
+        self.edgeUnits = edges.map { $0.unitIndex }
+        self.nodeOpenings = nodeOpenings
+        self.nodesByUnit = nodesByUnit
+        self.freeSpaceNodesByOrdinal = freeSpaceNodesByOrdinal
+        self.freeSpaceGrids = freeSpaceGrids
+        self.geometry = geometry
+    }
+
+    // Calls `body` with the target, weight in meters and index of every edge of `node` the profile allows.
+    // Without a metric the weight is the length, edges the metric closes are skipped.
+    func forEachEdge(from node: Int32, profile: Profile, metric: NavigationMetric? = nil, _ body: (Int32, Double, Int32) -> Void) {
+        for edge in Int(edgeOffsets[Int(node)])..<Int(edgeOffsets[Int(node) + 1]) where profile.allows(edgeAttributes[edge]) {
+            let weight = metric?.weight(ofEdge: edge) ?? Double(edgeLengths[edge])
+            if weight < .infinity {
+                body(edgeTargets[edge], weight, Int32(edge))
+            }
+        }
+    }
+
+    func length(ofEdge edge: Int) -> Double {
+        return Double(edgeLengths[edge])
+    }
+
+    func unitIndex(ofEdge edge: Int) -> Int {
+        return Int(edgeUnits[edge])
+    }
+
+    // The opening an edge arrives at, -1 when it arrives at a connector
+    func openingIndex(ofEdgeTarget edge: Int) -> Int {
+        return Int(nodeOpenings[Int(edgeTargets[edge])])
+    }
+
+    // Nodes a point can walk to directly: the nodes of its unit, or the nearest nodes in the open space
+    func accessNodes(around mapPoint: MKMapPoint, ordinalValue: Int) -> (nodes: [Int32], unitIndex: Int?) {
+        if let unitIndex = geometry.unitIndex(containing: mapPoint, ordinalValue: ordinalValue), let nodes = nodesByUnit[unitIndex] {
+            return (nodes, unitIndex)
+        }
+
+        guard let nodes = freeSpaceNodesByOrdinal[ordinalValue], let grid = freeSpaceGrids[ordinalValue] else { return ([], nil) }
+
+        let nearest = grid.nearestItems(to: mapPoint, count: NavigationGraph.freeSpaceNeighbourCount) {
+            distance(mapPoint, nodeMapPoints[Int(nodes[$0])])
+        }
+
+        return (nearest.map { nodes[$0] }, nil)
+    }
+
+    // A* search, the straight line distance ignores floors and stays a lower bound for every profile
+    func route(from start: MKMapPoint, fromOrdinalValue: Int, to end: MKMapPoint, toOrdinalValue: Int,
+               profile: Profile, metric: NavigationMetric? = nil) -> Route? {
+        let startAccess = accessNodes(around: start, ordinalValue: fromOrdinalValue)
+        let endAccess = accessNodes(around: end, ordinalValue: toOrdinalValue)
+
+        var bestCost = Double.infinity
+        var bestNode: Int32 = -1
+
+        // Same unit, or both in the open space of one floor, unless a wall is in the way
+        if fromOrdinalValue == toOrdinalValue, startAccess.unitIndex == endAccess.unitIndex,
+           !(startAccess.unitIndex.map { metric?.isClosed(.unit($0)) ?? false } ?? false),
+           !geometry.crossesWall(from: start, to: end, ordinalValue: fromOrdinalValue) {
+            bestCost = distance(start, end)
+        }
+
+        var goalCosts: [Int32: Double] = [:]
+        for node in endAccess.nodes {
+            goalCosts[node] = distance(nodeMapPoints[Int(node)], end)
+        }
+
+        var costs = [Double](repeating: .infinity, count: nodeCount)
+        var previous = [Int32](repeating: -1, count: nodeCount)
+        var previousEdges = [Int32](repeating: -1, count: nodeCount)
+        var queue = PriorityQueue()
+
+        func heuristic(_ node: Int32) -> Double {
+            return distance(nodeMapPoints[Int(node)], end)
+        }
+
+        for node in startAccess.nodes {
+            let cost = distance(start, nodeMapPoints[Int(node)])
+            if cost < costs[Int(node)] {
+                costs[Int(node)] = cost
+                queue.push(node, cost: cost + heuristic(node))
+            }
+        }
+
+        while let entry = queue.pop(), entry.cost < bestCost {
+            let node = entry.node
+            let cost = costs[Int(node)]
+            guard entry.cost <= cost + heuristic(node) + 1e-9 else { continue }
+
+            if let goalCost = goalCosts[node], cost + goalCost < bestCost {
+                bestCost = cost + goalCost
+                bestNode = node
+            }
+
+            forEachEdge(from: node, profile: profile, metric: metric) { target, weight, edge in
+                let targetCost = cost + weight
+                if targetCost < costs[Int(target)] {
+                    costs[Int(target)] = targetCost
+                    previous[Int(target)] = node
+                    previousEdges[Int(target)] = edge
+                    queue.push(target, cost: targetCost + heuristic(target))
+                }
+            }
+        }
+
+        guard bestCost < .infinity else { return nil }
+
+        var nodes: [Int32] = []
+        var edges: [Int32] = []
+        var node = bestNode
+        while node >= 0 {
+            nodes.append(node)
+            if previousEdges[Int(node)] >= 0 {
+                edges.append(previousEdges[Int(node)])
+            }
+            node = previous[Int(node)]
+        }
+
+        let vertices = [RouteStepBuilder.Vertex(mapPoint: start, ordinalValue: fromOrdinalValue)]
+            + nodes.reversed().map { RouteStepBuilder.Vertex(mapPoint: nodeMapPoints[Int($0)], ordinalValue: nodeOrdinals[Int($0)]) }
+            + [RouteStepBuilder.Vertex(mapPoint: end, ordinalValue: toOrdinalValue)]
+
+        return Route(vertices: vertices, edges: edges.reversed(), distance: bestCost)
+    }
+
+    // Dijkstra bounded by `maxDistance` meters: the walkable units reached and the distance at which each is entered.
+    // Costs live in a dictionary, so the search only touches the reached part of the venue.
+    func reachableUnits(from start: MKMapPoint, ordinalValue: Int, maxDistance: CLLocationDistance,
+                        profile: Profile, metric: NavigationMetric? = nil) -> [Int: CLLocationDistance] {
+        let startAccess = accessNodes(around: start, ordinalValue: ordinalValue)
+
+        var unitDistances: [Int: CLLocationDistance] = [:]
+        if let unitIndex = startAccess.unitIndex, !(metric?.isClosed(.unit(unitIndex)) ?? false) {
+            unitDistances[unitIndex] = 0
+        }
+
+        var costs: [Int32: Double] = [:]
+        var queue = PriorityQueue()
+
+        for node in startAccess.nodes {
+            let cost = distance(start, nodeMapPoints[Int(node)])
+            if cost <= maxDistance, cost < costs[node] ?? .infinity {
+                costs[node] = cost
+                queue.push(node, cost: cost)
+            }
+        }
+
+        while let entry = queue.pop() {
+            let node = entry.node
+            guard entry.cost <= costs[node] ?? .infinity else { continue }
+
+            forEachEdge(from: node, profile: profile, metric: metric) { target, weight, edge in
+                let unitIndex = Int(edgeUnits[Int(edge)])
+                if unitIndex >= 0, entry.cost < unitDistances[unitIndex] ?? .infinity {
+                    unitDistances[unitIndex] = entry.cost
+                }
+
+                let targetCost = entry.cost + weight
+                if targetCost <= maxDistance, targetCost < costs[target] ?? .infinity {
+                    costs[target] = targetCost
+                    queue.push(target, cost: targetCost)
+                }
+            }
+        }
+
+        return unitDistances
+    }
+
+    private func distance(_ a: MKMapPoint, _ b: MKMapPoint) -> Double {
+        return hypot(a.x - b.x, a.y - b.y) / geometry.mapPointsPerMeter
+    }
+
+    private static func attributes(of unit: VenueGeometry.Unit) -> EdgeAttributes {
+        var attributes: EdgeAttributes = []
+
+        if unit.category.contains("Stairs") {
+            attributes.insert(.stairs)
+        }
+        if unit.category.contains("Escalator") {
+            attributes.insert(.escalator)
+        }
+        if unit.category.contains("Elevator") {
+            attributes.insert(.elevator)
+        }
+        if unit.category == "Non-Public" {
+            attributes.insert(.staffOnly)
+        }
+        if unit.category.contains("Security") {
+            attributes.insert(.securityCrossing)
+        }
+
+        return attributes
+    }
+}
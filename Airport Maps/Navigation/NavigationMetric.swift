@@ -0,0 +1,114 @@
+//
+//  NavigationMetric.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import Foundation
+
+// Live edge weights on top of a NavigationGraph: closed corridors, queues at security or an escalator out of service.
+// The edges each unit and opening affects are collected once, so changing an override only re-weighs those edges
+// and leaves the graph and the rest of the weights as they are.
+// A unit penalty is added to every edge walked in the unit, an opening penalty to every edge arriving at the opening.
+// All methods must be called on the main queue.
+final class NavigationMetric {
+    enum Element: Hashable {
+        case unit(Int) // index in VenueGeometry.units, connector units included
+        case opening(Int) // index in VenueGeometry.openings
+    }
+
+    enum Override: Equatable {
+        case penalty(TimeInterval)
+        case closed
+    }
+
+    let graph: NavigationGraph
+
+    private(set) var overrides: [Element: Override] = [:]
+
+    private var weights: [Float] // meters, infinity when closed
+    private let edgesByElement: [Element: [Int32]]
+
+    var byteCount: Int {
+        return weights.count * MemoryLayout<Float>.stride
+            + edgesByElement.values.reduce(0) { $0 + MemoryLayout<Element>.stride + $1.count * MemoryLayout<Int32>.stride }
+    }
+
+    init(graph: NavigationGraph) {
+        var weights = [Float](repeating: 0, count: graph.edgeCount)
+        var edgesByElement: [Element: [Int32]] = [:]
+
+        for edge in 0..<graph.edgeCount {
+            weights[edge] = Float(graph.length(ofEdge: edge))
+
+            let unitIndex = graph.unitIndex(ofEdge: edge)
+            if unitIndex >= 0 {
+                edgesByElement[.unit(unitIndex), default: []].append(Int32(edge))
+            }
+            let openingIndex = graph.openingIndex(ofEdgeTarget: edge)
+            if openingIndex >= 0 {
+                edgesByElement[.opening(openingIndex), default: []].append(Int32(edge))
+            }
+        }
+
+        self.graph = graph
+        self.weights = weights
+        self.edgesByElement = edgesByElement
+    }
+
+    func weight(ofEdge edge: Int) -> Double {
+        return Double(weights[edge])
+    }
+
+    func isClosed(_ element: Element) -> Bool {
+        return overrides[element] == .closed
+    }
+
+    // Sets or clears the override of an element and returns the edges whose weight changed
+    @discardableResult
+    func setOverride(_ override: Override?, for element: Element) -> Set<Int32> {
+        guard overrides[element] != override else { return [] }
+
+        overrides[element] = override
+
+        var changedEdges = Set<Int32>()
+        for edge in edgesByElement[element] ?? [] {
+            let weight = customizedWeight(ofEdge: Int(edge))
+            if weight != weights[Int(edge)] {
+                weights[Int(edge)] = weight
+                changedEdges.insert(edge)
+            }
+        }
+
+        return changedEdges
+    }
+
+    // Clears every override and returns the edges whose weight changed
+    @discardableResult
+    func removeAllOverrides() -> Set<Int32> {
+        var changedEdges = Set<Int32>()
+        for element in Array(overrides.keys) {
+            changedEdges.formUnion(setOverride(nil, for: element))
+        }
+
+        return changedEdges
+    }
+
+    private func customizedWeight(ofEdge edge: Int) -> Float {
+        var weight = graph.length(ofEdge: edge)
+
+        for element in [Element.unit(graph.unitIndex(ofEdge: edge)), .opening(graph.openingIndex(ofEdgeTarget: edge))] {
+            switch overrides[element] {
+            case .closed:
+                return .infinity
+            case .penalty(let seconds):
+                weight += max(seconds, 0) * NavigationGraph.walkingSpeed
+            case nil:
+                break
+            }
+        }
+
+        return Float(weight)
+    }
+}
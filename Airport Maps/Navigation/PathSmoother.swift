@@ -0,0 +1,118 @@
+//
+//  PathSmoother.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+
+// Pulls a route path taut through the openings it passes, using the simple stupid funnel algorithm.
+// Every opening crossed by the path becomes a portal, the funnel then keeps only the corners where
+// the path has to bend around an opening side. Floors are smoothed separately, floor changes stay as they are.
+enum PathSmoother {
+    typealias Vertex = RouteStepBuilder.Vertex
+
+    private struct Portal {
+        let left: MKMapPoint
+        let right: MKMapPoint
+    }
+
+    static func smooth(_ path: [Vertex], geometry: VenueGeometry) -> [Vertex] {
+        guard path.count > 2 else { return path }
+
+        var smoothedPath: [Vertex] = []
+        var runStart = 0
+
+        for index in 1...path.count where index == path.count || path[index].ordinalValue != path[runStart].ordinalValue {
+            let run = Array(path[runStart..<index])
+            smoothedPath.append(contentsOf: run.count > 2 ? smoothRun(run, geometry: geometry) : run)
+            runStart = index
+        }
+
+        return smoothedPath
+    }
+
+    private static func smoothRun(_ run: [Vertex], geometry: VenueGeometry) -> [Vertex] {
+        let ordinalValue = run[0].ordinalValue
+
+        var portals = [Portal(left: run[0].mapPoint, right: run[0].mapPoint)]
+        for (start, end) in zip(run, run.dropFirst()) {
+            for (a, b) in geometry.openingSegments(crossedFrom: start.mapPoint, to: end.mapPoint, ordinalValue: ordinalValue) {
+                portals.append(area2(start.mapPoint, end.mapPoint, a) < 0 ? Portal(left: a, right: b) : Portal(left: b, right: a))
+            }
+        }
+        portals.append(Portal(left: run[run.count - 1].mapPoint, right: run[run.count - 1].mapPoint))
+
+        let points = funnel(portals)
+
+        // Units are not convex, keep the original run when a shortcut cuts through a wall
+        for (a, b) in zip(points, points.dropFirst()) where geometry.crossesWall(from: a, to: b, ordinalValue: ordinalValue) {
+            return run
+        }
+
+        return points.map { Vertex(mapPoint: $0, ordinalValue: ordinalValue) }
+    }
+
+    private static func funnel(_ portals: [Portal]) -> [MKMapPoint] {
+        var points = [portals[0].left]
+        var apex = portals[0].left, left = apex, right = apex
+        var apexIndex = 0, leftIndex = 0, rightIndex = 0
+
+        var index = 1
+        while index < portals.count {
+            let portal = portals[index]
+
+            // Narrow the funnel from the right
+            if area2(apex, right, portal.right) <= 0 {
+                if isSamePoint(apex, right) || area2(apex, left, portal.right) > 0 {
+                    right = portal.right
+                    rightIndex = index
+                } else {
+                    // The right side crossed the left one, the left point is a corner of the path
+                    points.append(left)
+                    apex = left
+                    apexIndex = leftIndex
+                    right = apex
+                    rightIndex = apexIndex
+                    index = apexIndex + 1
+                    continue
+                }
+            }
+
+            // Narrow the funnel from the left
+            if area2(apex, left, portal.left) >= 0 {
+                if isSamePoint(apex, left) || area2(apex, right, portal.left) < 0 {
+                    left = portal.left
+                    leftIndex = index
+                } else {
+                    points.append(right)
+                    apex = right
+                    apexIndex = rightIndex
+                    left = apex
+                    leftIndex = apexIndex
+                    index = apexIndex + 1
+                    continue
+                }
+            }
+
+            index += 1
+        }
+
+        let end = portals[portals.count - 1].left
+        if !isSamePoint(points[points.count - 1], end) {
+            points.append(end)
+        }
+
+        return points
+    }
+
+    private static func isSamePoint(_ a: MKMapPoint, _ b: MKMapPoint) -> Bool {
+        return a.x == b.x && a.y == b.y
+    }
+
+    // Twice the signed area of the triangle, the sign tells on which side of a -> b the point c lies
+    private static func area2(_ a: MKMapPoint, _ b: MKMapPoint, _ c: MKMapPoint) -> Double {
+        return (c.x - a.x) * (b.y - a.y) - (b.x - a.x) * (c.y - a.y)
+    }
+}
@@ -0,0 +1,59 @@
+//
+//  PriorityQueue.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+// Binary min-heap of graph nodes keyed by cost, stale entries are skipped by the caller
+struct PriorityQueue {
+    private var elements: [(cost: Double, node: Int32)] = []
+
+    var isEmpty: Bool {
+        return elements.isEmpty
+    }
+
+    var minimumCost: Double? {
+        return elements.first?.cost
+    }
+
+    mutating func push(_ node: Int32, cost: Double) {
+        elements.append((cost, node))
+
+        var child = elements.count - 1
+        while child > 0 {
+            let parent = (child - 1) / 2
+            guard elements[child].cost < elements[parent].cost else { break }
+
+            elements.swapAt(child, parent)
+            child = parent
+        }
+    }
+
+    mutating func pop() -> (cost: Double, node: Int32)? {
+        guard let first = elements.first else { return nil }
+
+        let last = elements.removeLast()
+        guard !elements.isEmpty else { return first }
+
+        elements[0] = last
+        var parent = 0
+        while true {
+            let left = 2 * parent + 1, right = left + 1
+            var smallest = parent
+
+            if left < elements.count, elements[left].cost < elements[smallest].cost {
+                smallest = left
+            }
+            if right < elements.count, elements[right].cost < elements[smallest].cost {
+                smallest = right
+            }
+            guard smallest != parent else { break }
+
+            elements.swapAt(parent, smallest)
+            parent = smallest
+        }
+
+        return first
+    }
+}
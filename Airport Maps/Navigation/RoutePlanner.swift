@@ -0,0 +1,154 @@
+//
+//  RoutePlanner.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import QuartzCore
+import os.log
+
+// App side routes over the venue's NavigationGraph that follow live closures and penalties.
+// When an override changes, only the routes walking a re-weighed edge are calculated again; when an
+// override is relaxed every route may get shorter, so all routes are calculated again.
+// Routes go through the same states as a PC_IndoorMapRoute. The manager's own routes never read the
+// NavigationMetric, only routes made here follow the overrides. All methods must be called on the main queue.
+final class RoutePlanner {
+    struct Request {
+        let start: MKMapPoint
+        let fromOrdinalValue: Int
+        let end: MKMapPoint
+        let toOrdinalValue: Int
+        let profile: NavigationGraph.Profile
+    }
+
+    final class PlannedRoute {
+        let identifier: String
+        let request: Request
+        fileprivate(set) var state = PC_IndoorMapRouteState.idle
+        fileprivate(set) var route: NavigationGraph.Route?
+
+        fileprivate init(identifier: String, request: Request) {
+            self.identifier = identifier
+            self.request = request
+        }
+    }
+
+    let metric: NavigationMetric
+
+    // Called after every state change of a route
+    var routeDidChangeState: ((PlannedRoute) -> Void)?
+
+    private var routes: [String: PlannedRoute] = [:]
+    private let geometry: VenueGeometry
+
+    var routeByteCount: Int {
+        return routes.values.reduce(0) { total, route in
+            total + MemoryLayout<PlannedRoute>.size + (route.route.map {
+                $0.vertices.count * MemoryLayout<RouteStepBuilder.Vertex>.stride + $0.edges.count * MemoryLayout<Int32>.stride
+            } ?? 0)
+        }
+    }
+
+    private lazy var elementsByIdentifier: [String: NavigationMetric.Element] = {
+        var elementsByIdentifier: [String: NavigationMetric.Element] = [:]
+        for (index, unit) in geometry.units.enumerated() {
+            elementsByIdentifier[unit.identifier] = .unit(index)
+        }
+        for (index, opening) in geometry.openings.enumerated() {
+            elementsByIdentifier[opening.identifier] = .opening(index)
+        }
+
+        return elementsByIdentifier
+    }()
+
+    init(graph: NavigationGraph, geometry: VenueGeometry) {
+        self.metric = NavigationMetric(graph: graph)
+        self.geometry = geometry
+    }
+
+    @discardableResult
+    func makeRoute(identifier: String, request: Request) -> PlannedRoute {
+        if let route = routes[identifier] {
+            removeRoute(route)
+        }
+
+        let route = PlannedRoute(identifier: identifier, request: request)
+        routes[identifier] = route
+        calculate(route)
+
+        return route
+    }
+
+    func route(forIdentifier identifier: String) -> PlannedRoute? {
+        return routes[identifier]
+    }
+
+    func removeRoute(_ route: PlannedRoute) {
+        guard routes[route.identifier] === route else { return }
+
+        routes[route.identifier] = nil
+        route.route = nil
+        setState(.removed, of: route)
+    }
+
+    // Sets or clears the override of the unit or opening with this UNIT_ID or OPENING_ID, false when there is none
+    @discardableResult
+    func setOverride(_ override: NavigationMetric.Override?, forFeatureIdentifier identifier: String) -> Bool {
+        guard let element = elementsByIdentifier[identifier] else { return false }
+
+        setOverride(override, for: element)
+
+        return true
+    }
+
+    func setOverride(_ override: NavigationMetric.Override?, for element: NavigationMetric.Element) {
+        let isRelaxed = RoutePlanner.isRelaxed(from: metric.overrides[element], to: override)
+
+        let startTime = CACurrentMediaTime()
+        let changedEdges = metric.setOverride(override, for: element)
+        os_log("Re-weighed %ld edges in %.2f ms", type: .info, changedEdges.count, (CACurrentMediaTime() - startTime) * 1000)
+
+        guard !changedEdges.isEmpty else { return }
+
+        for route in routes.values {
+            if isRelaxed || route.state != .completed || route.route?.edges.contains(where: changedEdges.contains) ?? true {
+                calculate(route)
+            }
+        }
+    }
+
+    private func calculate(_ route: PlannedRoute) {
+        setState(.calculating, of: route)
+
+        let request = route.request
+        route.route = Trace.span("route") {
+            metric.graph.route(from: request.start, fromOrdinalValue: request.fromOrdinalValue, to: request.end,
+                               toOrdinalValue: request.toOrdinalValue, profile: request.profile, metric: metric)
+        }
+
+        setState(route.route != nil ? .completed : .failed, of: route)
+    }
+
+    private func setState(_ state: PC_IndoorMapRouteState, of route: PlannedRoute) {
+        route.state = state
+        routeDidChangeState?(route)
+    }
+
+    // Whether any edge can get cheaper, a penalty that grows or a new closure only makes edges more expensive
+    private static func isRelaxed(from oldOverride: NavigationMetric.Override?, to newOverride: NavigationMetric.Override?) -> Bool {
+        switch (oldOverride, newOverride) {
+        case (nil, _):
+            return false
+        case (.closed, .closed):
+            return false
+        case (.closed, _), (_, nil):
+            return true
+        case (.penalty(let oldSeconds), .penalty(let newSeconds)):
+            return newSeconds < oldSeconds
+        case (.penalty, .closed):
+            return false
+        }
+    }
+}
@@ -0,0 +1,159 @@
+//
+//  RouteStepBuilder.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import QuartzCore
+import os.log
+
+// Splits a route path into turn-by-turn steps at turns and floor changes and picks a landmark for each step.
+// The landmark of a path edge is looked up once and cached, so recomputed routes over the same edges reuse it.
+// All methods must be called on the main queue.
+final class RouteStepBuilder {
+    struct Vertex {
+        let mapPoint: MKMapPoint
+        let ordinalValue: Int
+    }
+
+    enum Maneuver {
+        case depart
+        case turn(angle: Double) // degrees, positive is a right turn
+        case changeFloor(connectorCategory: String?, ordinalValue: Int)
+    }
+
+    struct Step {
+        let maneuver: Maneuver
+        let vertices: [Vertex]
+        let landmark: LandmarkIndex.Landmark?
+
+        var ordinalValue: Int {
+            return vertices[0].ordinalValue
+        }
+    }
+
+    var turnAngleThreshold = 35.0 // degrees
+    var corridorWidth = 8.0 // meters
+
+    private let geometry: VenueGeometry
+    private let landmarkIndex: LandmarkIndex
+
+    private struct EdgeKey: Hashable {
+        let x0: Int64, y0: Int64, x1: Int64, y1: Int64, ordinalValue: Int
+    }
+
+    private var landmarksByEdge: [EdgeKey: Int] = [:] // -1 when the edge has no landmark
+
+    var landmarkIndexByteCount: Int {
+        return landmarkIndex.byteCount
+    }
+
+    var cacheByteCount: Int {
+        return landmarksByEdge.count * (MemoryLayout<EdgeKey>.stride + MemoryLayout<Int>.stride)
+    }
+
+    init(geometry: VenueGeometry, landmarkIndex: LandmarkIndex) {
+        self.geometry = geometry
+        self.landmarkIndex = landmarkIndex
+    }
+
+    func steps(for path: [Vertex]) -> [Step] {
+        guard path.count >= 2 else { return [] }
+
+        let startTime = CACurrentMediaTime()
+        var steps: [Step] = []
+        var maneuver = Maneuver.depart
+        var stepVertices = [path[0]]
+
+        func finishStep() {
+            steps.append(Step(maneuver: maneuver, vertices: stepVertices, landmark: landmark(along: stepVertices)))
+        }
+
+        for index in 1..<path.count {
+            let vertex = path[index]
+            let previous = path[index - 1]
+
+            if vertex.ordinalValue != previous.ordinalValue {
+                finishStep()
+                maneuver = .changeFloor(connectorCategory: connectorCategory(at: previous), ordinalValue: vertex.ordinalValue)
+                stepVertices = [vertex]
+                continue
+            }
+
+            stepVertices.append(vertex)
+
+            guard index + 1 < path.count, path[index + 1].ordinalValue == vertex.ordinalValue else { continue }
+
+            let angle = RouteStepBuilder.turnAngle(previous.mapPoint, vertex.mapPoint, path[index + 1].mapPoint)
+            if abs(angle) >= turnAngleThreshold {
+                finishStep()
+                maneuver = .turn(angle: angle)
+                stepVertices = [vertex]
+            }
+        }
+
+        if stepVertices.count >= 2 || steps.isEmpty {
+            finishStep()
+        }
+
+        os_log("Built %ld steps for a %ld vertex route in %.2f ms", type: .info, steps.count, path.count,
+               (CACurrentMediaTime() - startTime) * 1000)
+
+        return steps
+    }
+
+    // The best ranked landmark near the last edges of the step, where the next maneuver happens
+    private func landmark(along vertices: [Vertex]) -> LandmarkIndex.Landmark? {
+        var best: Int?
+
+        for (a, b) in zip(vertices, vertices.dropFirst()).reversed() {
+            let index = cachedLandmark(from: a, to: b)
+            if index >= 0, best.map({ landmarkIndex.landmarks[index].rank < landmarkIndex.landmarks[$0].rank }) ?? true {
+                best = index
+            }
+            if let best = best, landmarkIndex.landmarks[best].rank == 0 {
+                break
+            }
+        }
+
+        return best.map { landmarkIndex.landmarks[$0] }
+    }
+
+    private func cachedLandmark(from a: Vertex, to b: Vertex) -> Int {
+        let key = EdgeKey(x0: Int64(a.mapPoint.x.rounded()), y0: Int64(a.mapPoint.y.rounded()),
+                          x1: Int64(b.mapPoint.x.rounded()), y1: Int64(b.mapPoint.y.rounded()), ordinalValue: a.ordinalValue)
+        if let index = landmarksByEdge[key] {
+            return index
+        }
+
+        let index = landmarkIndex.landmarks(alongSegmentFrom: a.mapPoint, to: b.mapPoint, ordinalValue: a.ordinalValue,
+                                            corridorWidth: corridorWidth * geometry.mapPointsPerMeter).first ?? -1
+        landmarksByEdge[key] = index
+
+        return index
+    }
+
+    private func connectorCategory(at vertex: Vertex) -> String? {
+        guard let unitIndex = geometry.unitIndex(containing: vertex.mapPoint, ordinalValue: vertex.ordinalValue),
+              geometry.units[unitIndex].isVerticalConnector else { return nil }
+
+        return geometry.units[unitIndex].category
+    }
+
+    // Signed angle between the two edges in degrees, map points have y pointing south
+    private static func turnAngle(_ a: MKMapPoint, _ b: MKMapPoint, _ c: MKMapPoint) -> Double {
+        let heading1 = atan2(b.y - a.y, b.x - a.x)
+        let heading2 = atan2(c.y - b.y, c.x - b.x)
+        var angle = (heading2 - heading1) * 180 / .pi
+
+        if angle > 180 {
+            angle -= 360
+        } else if angle < -180 {
+            angle += 360
+        }
+
+        return angle
+    }
+}
@@ -0,0 +1,177 @@
+//
+//  IMDFRelationships.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import Foundation
+import os.log
+
+// Resolved links between the features of an IMDF archive. Every layer gets one hash table from
+// feature id to its position in the file, after which each layer is resolved in a single pass and
+// references are stored as dense indices, `IMDFRelationships.unresolved` marking a missing target.
+final class IMDFRelationships {
+    enum Layer: String, CaseIterable {
+        case building, level, unit, opening, anchor, occupant, amenity, fixture
+
+        // The manager's layer type of the features of this layer
+        init?(layerType: PC_IndoorMapLayerType) {
+            switch layerType {
+            case .buildings: self = .building
+            case .levels: self = .level
+            case .units: self = .unit
+            case .openings: self = .opening
+            case .anchors: self = .anchor
+            case .occupants: self = .occupant
+            case .points: self = .amenity
+            case .fixtures: self = .fixture
+            default: return nil
+            }
+        }
+    }
+
+    static let unresolved: Int32 = -1
+
+    // Feature ids per layer, in file order, dense indices point into these arrays
+    let identifiers: [Layer: [String]]
+
+    let levelOrdinals: [Int]
+    let levelBuildings: [[Int32]]
+    let unitLevels: [Int32]
+    let openingLevels: [Int32]
+    let anchorUnits: [Int32]
+    let occupantAnchors: [Int32]
+    let amenityUnits: [[Int32]]
+    let fixtureLevels: [Int32]
+
+    // Number of references per layer whose target does not exist
+    let danglingReferenceCounts: [Layer: Int]
+
+    private let indicesByIdentifier: [Layer: [String: Int32]]
+
+    convenience init?(directoryPath: String) {
+        var featuresByLayer: [Layer: [[String: Any]]] = [:]
+        for layer in Layer.allCases {
+            featuresByLayer[layer] = VenueGeometry.features(inFile: layer.rawValue, directoryPath: directoryPath) ?? []
+        }
+
+        self.init(featuresByLayer: featuresByLayer)
+    }
+
+    // Resolves the parsed GeoJSON features of every layer, VenueGeometry passes the files it already read
+    init?(featuresByLayer: [Layer: [[String: Any]]]) {
+        var propertiesByLayer: [Layer: [[String: Any]]] = [:]
+        var identifiers: [Layer: [String]] = [:]
+        var indicesByIdentifier: [Layer: [String: Int32]] = [:]
+
+        // Hash tables first, so every reference below is a single lookup
+        for layer in Layer.allCases {
+            let features = featuresByLayer[layer] ?? []
+            var layerIdentifiers: [String] = []
+            var layerIndices: [String: Int32] = [:]
+            layerIdentifiers.reserveCapacity(features.count)
+            layerIndices.reserveCapacity(features.count)
+
+            for feature in features {
+                let identifier = feature["id"] as? String ?? ""
+                layerIndices[identifier] = Int32(layerIdentifiers.count)
+                layerIdentifiers.append(identifier)
+            }
+
+            propertiesByLayer[layer] = features.map { $0["properties"] as? [String: Any] ?? [:] }
+            identifiers[layer] = layerIdentifiers
+            indicesByIdentifier[layer] = layerIndices
+        }
+
+        guard !(identifiers[.level] ?? []).isEmpty, !(identifiers[.unit] ?? []).isEmpty else { return nil }
+
+        var danglingReferenceCounts: [Layer: Int] = [:]
+
+        func resolve(_ layer: Layer, key: String, target: Layer) -> [Int32] {
+            let targetIndices = indicesByIdentifier[target] ?? [:]
+
+            return (propertiesByLayer[layer] ?? []).map { properties in
+                guard let identifier = properties[key] as? String else { return IMDFRelationships.unresolved }
+                guard let index = targetIndices[identifier] else {
+                    danglingReferenceCounts[layer, default: 0] += 1
+                    return IMDFRelationships.unresolved
+                }
+
+                return index
+            }
+        }
+
+        func resolveAll(_ layer: Layer, key: String, target: Layer) -> [[Int32]] {
+            let targetIndices = indicesByIdentifier[target] ?? [:]
+
+            return (propertiesByLayer[layer] ?? []).map { properties in
+                let references = properties[key] as? [String] ?? []
+                let indices = references.compactMap { targetIndices[$0] }
+                danglingReferenceCounts[layer, default: 0] += references.count - indices.count
+
+                return indices
+            }
+        }
+
+        self.levelOrdinals = (propertiesByLayer[.level] ?? []).map { $0["ordinal"] as? Int ?? 0 }
+        self.levelBuildings = resolveAll(.level, key: "building_ids", target: .building)
+        self.unitLevels = resolve(.unit, key: "level_id", target: .level)
+        self.openingLevels = resolve(.opening, key: "level_id", target: .level)
+        self.anchorUnits = resolve(.anchor, key: "unit_id", target: .unit)
+        self.occupantAnchors = resolve(.occupant, key: "anchor_id", target: .anchor)
+        self.amenityUnits = resolveAll(.amenity, key: "unit_ids", target: .unit)
+        self.fixtureLevels = resolve(.fixture, key: "level_id", target: .level)
+        self.identifiers = identifiers
+        self.indicesByIdentifier = indicesByIdentifier
+        self.danglingReferenceCounts = danglingReferenceCounts
+
+        for (layer, count) in danglingReferenceCounts where count > 0 {
+            os_log("IMDF %{public}@ layer has %ld dangling references", type: .error, layer.rawValue, count)
+        }
+    }
+
+    func index(of identifier: String, in layer: Layer) -> Int? {
+        return indicesByIdentifier[layer]?[identifier].map(Int.init)
+    }
+
+    // Occupant -> anchor -> unit -> level
+    func levelIndex(ofOccupant occupantIndex: Int) -> Int? {
+        guard let anchorIndex = resolved(occupantAnchors[occupantIndex]),
+              let unitIndex = resolved(anchorUnits[anchorIndex]) else { return nil }
+
+        return resolved(unitLevels[unitIndex])
+    }
+
+    // The units a unit, anchor, occupant or amenity is in, as indices into the unit layer
+    func unitIndices(ofFeatureAt index: Int, in layer: Layer) -> [Int] {
+        switch layer {
+        case .unit:
+            return [index]
+        case .anchor:
+            return resolved(anchorUnits[index]).map { [$0] } ?? []
+        case .occupant:
+            return resolved(occupantAnchors[index]).flatMap { resolved(anchorUnits[$0]) }.map { [$0] } ?? []
+        case .amenity:
+            return amenityUnits[index].map(Int.init)
+        default:
+            return []
+        }
+    }
+
+    func ordinalValue(ofUnit unitIndex: Int) -> Int? {
+        return resolved(unitLevels[unitIndex]).map { levelOrdinals[$0] }
+    }
+
+    func ordinalValue(ofOpening openingIndex: Int) -> Int? {
+        return resolved(openingLevels[openingIndex]).map { levelOrdinals[$0] }
+    }
+
+    func ordinalValue(ofOccupant occupantIndex: Int) -> Int? {
+        return levelIndex(ofOccupant: occupantIndex).map { levelOrdinals[$0] }
+    }
+
+    func resolved(_ reference: Int32) -> Int? {
+        return reference == IMDFRelationships.unresolved ? nil : Int(reference)
+    }
+}
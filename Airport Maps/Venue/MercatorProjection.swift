@@ -0,0 +1,94 @@
+//
+//  MercatorProjection.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import simd
+
+// Batch projection of GeoJSON positions to MKMapPoint.
+// Longitude maps linearly to x. For y, the Mercator term ln(tan(pi/4 + lat/2)) is replaced by its
+// Taylor series around the first latitude of the batch, evaluated four points at a time:
+//     y(lat0 + d) = y0 + s d + s t d^2/2 + s (t^2 + s^2) d^3/6 + s t (t^2 + 5 s^2) d^4/24
+// with s = sec(lat0) and t = tan(lat0). The remainder is bounded by max|y'''''| d^5/120, which for
+// |d| <= 0.005 rad (about 30 km) stays below 0.02 mm at 52 degrees and below 0.3 mm at 70 degrees.
+// Positions further from the reference, and batches beyond 70 degrees, use the exact projection.
+enum MercatorProjection {
+    static let maximumLatitudeDelta = 0.005
+    static let maximumReferenceLatitude = 70.0
+
+    private static let degreesToRadians = Double.pi / 180
+
+    // `positions` holds GeoJSON [longitude, latitude] pairs, entries with fewer values are skipped
+    static func mapPoints(of positions: [[Double]]) -> [MKMapPoint] {
+        var longitudes: [Double] = []
+        var latitudes: [Double] = []
+        longitudes.reserveCapacity(positions.count)
+        latitudes.reserveCapacity(positions.count)
+
+        for position in positions where position.count >= 2 {
+            longitudes.append(position[0])
+            latitudes.append(position[1])
+        }
+
+        return mapPoints(longitudes: longitudes, latitudes: latitudes)
+    }
+
+    static func mapPoints(longitudes: [Double], latitudes: [Double]) -> [MKMapPoint] {
+        let count = min(longitudes.count, latitudes.count)
+        guard count > 0 else { return [] }
+
+        let referenceLatitude = latitudes[0]
+        guard abs(referenceLatitude) <= maximumReferenceLatitude else {
+            return (0..<count).map { MKMapPoint(CLLocationCoordinate2D(latitude: latitudes[$0], longitude: longitudes[$0])) }
+        }
+
+        let worldWidth = MKMapSize.world.width
+        let xScale = worldWidth / 360
+        let yScale = worldWidth / (2 * .pi)
+
+        let phi0 = referenceLatitude * degreesToRadians
+        let s = 1 / cos(phi0), t = tan(phi0)
+        let y0 = log(tan(.pi / 4 + phi0 / 2))
+        let c1 = s, c2 = s * t / 2, c3 = s * (t * t + s * s) / 6, c4 = s * t * (t * t + 5 * s * s) / 24
+
+        var points = [MKMapPoint](repeating: MKMapPoint(), count: count)
+
+        longitudes.withUnsafeBufferPointer { longitudes in
+            latitudes.withUnsafeBufferPointer { latitudes in
+                var index = 0
+
+                while index + 4 <= count {
+                    let longitude = SIMD4<Double>(longitudes[index], longitudes[index + 1], longitudes[index + 2], longitudes[index + 3])
+                    let latitude = SIMD4<Double>(latitudes[index], latitudes[index + 1], latitudes[index + 2], latitudes[index + 3])
+
+                    let d = latitude * degreesToRadians - phi0
+                    let mercator = y0 + d * (c1 + d * (c2 + d * (c3 + d * c4)))
+                    let x = (longitude + 180) * xScale
+                    let y = worldWidth / 2 - mercator * yScale
+
+                    for lane in 0..<4 {
+                        points[index + lane] = abs(d[lane]) <= maximumLatitudeDelta ? MKMapPoint(x: x[lane], y: y[lane])
+                            : MKMapPoint(CLLocationCoordinate2D(latitude: latitude[lane], longitude: longitude[lane]))
+                    }
+                    index += 4
+                }
+
+                while index < count {
+                    let d = latitudes[index] * degreesToRadians - phi0
+                    if abs(d) <= maximumLatitudeDelta {
+                        let mercator = y0 + d * (c1 + d * (c2 + d * (c3 + d * c4)))
+                        points[index] = MKMapPoint(x: (longitudes[index] + 180) * xScale, y: worldWidth / 2 - mercator * yScale)
+                    } else {
+                        points[index] = MKMapPoint(CLLocationCoordinate2D(latitude: latitudes[index], longitude: longitudes[index]))
+                    }
+                    index += 1
+                }
+            }
+        }
+
+        return points
+    }
+}
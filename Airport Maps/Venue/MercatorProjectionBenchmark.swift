@@ -0,0 +1,86 @@
+//
+//  MercatorProjectionBenchmark.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+#if DEBUG
+import MapKit
+import QuartzCore
+import os.log
+
+// Compares the batch projection against MKMapPoint(_:) over every coordinate of a venue directory.
+// Run the app with the `-MercatorProjectionBenchmark` launch argument to log the result.
+extension MercatorProjection {
+    struct BenchmarkResult {
+        let coordinateCount: Int
+        let exactDuration: TimeInterval
+        let batchDuration: TimeInterval
+        let maximumErrorInMillimeters: Double
+    }
+
+    static func benchmark(directoryPath: String, iterations: Int = 10) -> BenchmarkResult {
+        let fileNames = (try? FileManager.default.contentsOfDirectory(atPath: directoryPath)) ?? []
+
+        // Every ring or line is one batch, as in VenueGeometry
+        var batches: [[[Double]]] = []
+        for fileName in fileNames where fileName.hasSuffix(".geojson") {
+            let path = (directoryPath as NSString).appendingPathComponent(fileName)
+
+            guard let data = FileManager.default.contents(atPath: path),
+                  let object = try? JSONSerialization.jsonObject(with: data) as? [String: Any],
+                  let features = object["features"] as? [[String: Any]] else { continue }
+
+            for feature in features {
+                let geometry = feature["geometry"] as? [String: Any]
+                collectBatches(in: geometry?["coordinates"], into: &batches)
+            }
+        }
+
+        let coordinateCount = batches.reduce(0) { $0 + $1.count }
+        var exactPoints: [[MKMapPoint]] = []
+        var batchPoints: [[MKMapPoint]] = []
+
+        var startTime = CACurrentMediaTime()
+        for _ in 0..<iterations {
+            exactPoints = batches.map { batch in
+                batch.map { MKMapPoint(CLLocationCoordinate2D(latitude: $0[1], longitude: $0[0])) }
+            }
+        }
+        let exactDuration = (CACurrentMediaTime() - startTime) / Double(iterations)
+
+        startTime = CACurrentMediaTime()
+        for _ in 0..<iterations {
+            batchPoints = batches.map { mapPoints(of: $0) }
+        }
+        let batchDuration = (CACurrentMediaTime() - startTime) / Double(iterations)
+
+        var maximumError = 0.0
+        for (exactBatch, batch) in zip(exactPoints, batchPoints) {
+            for (exact, point) in zip(exactBatch, batch) {
+                let error = hypot(exact.x - point.x, exact.y - point.y) / MKMapPointsPerMeterAtLatitude(exact.coordinate.latitude)
+                maximumError = max(maximumError, error * 1000)
+            }
+        }
+
+        let result = BenchmarkResult(coordinateCount: coordinateCount, exactDuration: exactDuration,
+                                     batchDuration: batchDuration, maximumErrorInMillimeters: maximumError)
+
+        os_log("Projected %ld coordinates, exact %.2f ms, batch %.2f ms, maximum error %.4f mm", type: .info,
+               result.coordinateCount, result.exactDuration * 1000, result.batchDuration * 1000, result.maximumErrorInMillimeters)
+
+        return result
+    }
+
+    private static func collectBatches(in coordinates: Any?, into batches: inout [[[Double]]]) {
+        if let positions = coordinates as? [[Double]] {
+            batches.append(positions.filter { $0.count >= 2 })
+        } else if let position = coordinates as? [Double], position.count >= 2 {
+            batches.append([position])
+        } else if let nested = coordinates as? [Any] {
+            nested.forEach { collectBatches(in: $0, into: &batches) }
+        }
+    }
+}
+#endif
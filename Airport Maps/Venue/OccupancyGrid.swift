@@ -0,0 +1,129 @@
+//
+//  OccupancyGrid.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+
+// Multi-resolution raster of a set of polygons for constant time point containment tests.
+// Cells without polygon edges are classified once as inside or outside, cells crossed by
+// edges are refined by a finer subgrid, and only the finest boundary cells fall back to
+// the exact polygon test.
+final class OccupancyGrid {
+    private enum CellState: UInt8 {
+        case outside, inside, boundary
+    }
+
+    private typealias Edge = (a: MKMapPoint, b: MKMapPoint)
+
+    private let rect: MKMapRect
+    private let columns: Int
+    private let rows: Int
+    private let cellWidth: Double
+    private let cellHeight: Double
+    private let polygons: [VenueGeometry.Polygon]
+    private var states: [CellState]
+    private var subgrids: [Int: OccupancyGrid] = [:]
+
+    convenience init(polygons: [VenueGeometry.Polygon]) {
+        let rect = polygons.reduce(MKMapRect.null) { $0.union($1.boundingRect) }
+        var edges: [Edge] = []
+        for polygon in polygons {
+            for ring in polygon.rings {
+                edges.append(contentsOf: zip(ring, ring.dropFirst() + [ring[0]]).map { (a: $0, b: $1) })
+            }
+        }
+
+        self.init(rect: rect, polygons: polygons, edges: edges, resolution: 64, depth: 2)
+    }
+
+    private init(rect: MKMapRect, polygons: [VenueGeometry.Polygon], edges: [Edge], resolution: Int, depth: Int) {
+        self.rect = rect
+        self.columns = rect.isNull || rect.isEmpty ? 0 : resolution
+        self.rows = rect.isNull || rect.isEmpty ? 0 : resolution
+        self.cellWidth = rect.size.width / Double(resolution)
+        self.cellHeight = rect.size.height / Double(resolution)
+        self.polygons = polygons
+        self.states = Array(repeating: .outside, count: columns * rows)
+
+        guard columns > 0 else { return }
+
+        // Edges mark every cell their bounding box touches, which is conservative but exact enough:
+        // a cell left unmarked is guaranteed to hold no edge
+        var edgesByCell: [Int: [Edge]] = [:]
+        for edge in edges {
+            let minColumn = column(of: min(edge.a.x, edge.b.x)), maxColumn = column(of: max(edge.a.x, edge.b.x))
+            let minRow = row(of: min(edge.a.y, edge.b.y)), maxRow = row(of: max(edge.a.y, edge.b.y))
+            guard minColumn < columns, maxColumn >= 0, minRow < rows, maxRow >= 0 else { continue }
+
+            for row in max(minRow, 0)...min(maxRow, rows - 1) {
+                for column in max(minColumn, 0)...min(maxColumn, columns - 1) {
+                    let index = row * columns + column
+                    states[index] = .boundary
+                    edgesByCell[index, default: []].append(edge)
+                }
+            }
+        }
+
+        // Runs of edge-free cells in a row share their state, one exact test per run is enough
+        for row in 0..<rows {
+            var runState: CellState? = nil
+            for column in 0..<columns {
+                let index = row * columns + column
+                guard states[index] != .boundary else {
+                    runState = nil
+                    continue
+                }
+
+                if runState == nil {
+                    runState = polygons.contains { $0.contains(center(ofColumn: column, row: row)) } ? .inside : .outside
+                }
+                states[index] = runState!
+            }
+        }
+
+        guard depth > 1 else { return }
+
+        for (index, cellEdges) in edgesByCell {
+            let cellRect = MKMapRect(x: rect.minX + Double(index % columns) * cellWidth, y: rect.minY + Double(index / columns) * cellHeight,
+                                     width: cellWidth, height: cellHeight)
+            subgrids[index] = OccupancyGrid(rect: cellRect, polygons: polygons, edges: cellEdges, resolution: 8, depth: depth - 1)
+        }
+    }
+
+    func contains(_ point: MKMapPoint) -> Bool {
+        guard rect.contains(point) else { return false }
+
+        let index = min(row(of: point.y), rows - 1) * columns + min(column(of: point.x), columns - 1)
+        switch states[index] {
+        case .outside:
+            return false
+        case .inside:
+            return true
+        case .boundary:
+            if let subgrid = subgrids[index] {
+                return subgrid.contains(point)
+            }
+            return polygons.contains { $0.contains(point) }
+        }
+    }
+
+    // Approximate memory used by the cell states of this grid and all its subgrids, in bytes
+    var byteCount: Int {
+        return states.count + subgrids.values.reduce(0) { $0 + $1.byteCount }
+    }
+
+    private func column(of x: Double) -> Int {
+        return Int(((x - rect.minX) / cellWidth).rounded(.down))
+    }
+
+    private func row(of y: Double) -> Int {
+        return Int(((y - rect.minY) / cellHeight).rounded(.down))
+    }
+
+    private func center(ofColumn column: Int, row: Int) -> MKMapPoint {
+        return MKMapPoint(x: rect.minX + (Double(column) + 0.5) * cellWidth, y: rect.minY + (Double(row) + 0.5) * cellHeight)
+    }
+}
@@ -0,0 +1,78 @@
+//
+//  OpeningAdjacency.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import os.log
+
+// The units every opening of a VenueGeometry connects. Opening lines are drawn on the walls between units, so
+// every opening segment is snapped to the unit edges running through its middle, found in the geometry's grid
+// of unit boundary segments.
+struct OpeningAdjacency {
+    struct Incidence {
+        let firstUnitIndex: Int
+        let openingIndex: Int
+        let secondUnitIndex: Int
+    }
+
+    // How far the middle of an opening segment may lie from a unit edge, in meters
+    static let snapTolerance = 0.25
+
+    // Indices in `geometry.units` of the units touching each opening, ascending
+    let unitIndices: [[Int]]
+
+    init(geometry: VenueGeometry) {
+        let tolerance = OpeningAdjacency.snapTolerance * geometry.mapPointsPerMeter
+
+        unitIndices = geometry.openings.map { opening in
+            var touchedUnits = Set<Int>()
+
+            opening.forEachSegment { a, b in
+                let middle = MKMapPoint(x: (a.x + b.x) / 2, y: (a.y + b.y) / 2)
+                let rect = MKMapRect(x: middle.x - tolerance, y: middle.y - tolerance, width: 2 * tolerance, height: 2 * tolerance)
+
+                geometry.forEachBoundarySegment(in: rect, ordinalValue: opening.ordinalValue) { index in
+                    let segment = geometry.boundarySegments[index]
+                    guard !touchedUnits.contains(segment.unitIndex),
+                          VenueGeometry.distance(from: middle, toSegmentFrom: segment.start, to: segment.end) <= tolerance else { return }
+
+                    touchedUnits.insert(segment.unitIndex)
+                }
+            }
+
+            return touchedUnits.sorted()
+        }
+    }
+
+    // Every pair of units an opening connects, once per pair
+    var incidences: [Incidence] {
+        var incidences: [Incidence] = []
+
+        for (openingIndex, units) in unitIndices.enumerated() {
+            for i in units.indices {
+                for j in units.indices where j > i {
+                    incidences.append(Incidence(firstUnitIndex: units[i], openingIndex: openingIndex, secondUnitIndex: units[j]))
+                }
+            }
+        }
+
+        return incidences
+    }
+
+    // Openings touching fewer than two units. One unit is expected for a door to the open space of a floor,
+    // none means the opening is drawn away from every unit wall.
+    var openingsWithFewerThanTwoUnits: [Int] {
+        return unitIndices.indices.filter { unitIndices[$0].count < 2 }
+    }
+
+    func log() {
+        let openings = openingsWithFewerThanTwoUnits
+        let unattachedCount = openings.filter { unitIndices[$0].isEmpty }.count
+
+        os_log("%ld openings, %ld touch one unit, %ld touch none", type: unattachedCount == 0 ? .info : .error,
+               unitIndices.count, openings.count - unattachedCount, unattachedCount)
+    }
+}
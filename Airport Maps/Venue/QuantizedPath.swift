@@ -0,0 +1,93 @@
+//
+//  QuantizedPath.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+
+// Ring or line of map points stored relative to an origin at a fixed resolution of 1/64 map point,
+// about 1.4 mm at the latitude of Amsterdam. Each coordinate is the Int16 delta to the previous
+// vertex, deltas that do not fit are written as an escape value followed by the absolute Int32.
+// Vertices are decoded sequentially, which is the order the polygon and segment tests need.
+struct QuantizedPath {
+    static let unitsPerMapPoint = 64.0
+
+    private static let escape = Int16.min
+
+    let count: Int
+    private let values: [Int16]
+
+    init(points: [MKMapPoint], origin: MKMapPoint) {
+        var values: [Int16] = []
+        values.reserveCapacity(points.count * 2)
+
+        func append(_ value: Int32, previous: Int32) {
+            let delta = Int(value) - Int(previous)
+            if delta > Int(Int16.min), delta <= Int(Int16.max) {
+                values.append(Int16(delta))
+            } else {
+                values.append(QuantizedPath.escape)
+                values.append(Int16(truncatingIfNeeded: value >> 16))
+                values.append(Int16(truncatingIfNeeded: value))
+            }
+        }
+
+        var previousX: Int32 = 0, previousY: Int32 = 0
+        for point in points {
+            let x = Int32(((point.x - origin.x) * QuantizedPath.unitsPerMapPoint).rounded())
+            let y = Int32(((point.y - origin.y) * QuantizedPath.unitsPerMapPoint).rounded())
+            append(x, previous: previousX)
+            append(y, previous: previousY)
+            previousX = x
+            previousY = y
+        }
+
+        self.count = points.count
+        self.values = values
+    }
+
+    var byteCount: Int {
+        return values.count * MemoryLayout<Int16>.stride
+    }
+
+    // Calls `body` with every vertex in quantized units relative to the origin
+    @inline(__always)
+    func forEachVertex(_ body: (Double, Double) -> Void) {
+        values.withUnsafeBufferPointer { values in
+            var index = 0
+            var x: Int32 = 0, y: Int32 = 0
+
+            @inline(__always)
+            func next(_ previous: Int32) -> Int32 {
+                let value = values[index]
+                guard value == QuantizedPath.escape else {
+                    index += 1
+                    return previous &+ Int32(value)
+                }
+
+                let decoded = Int32(values[index + 1]) << 16 | Int32(UInt16(bitPattern: values[index + 2]))
+                index += 3
+                return decoded
+            }
+
+            while index < values.count {
+                x = next(x)
+                y = next(y)
+                body(Double(x), Double(y))
+            }
+        }
+    }
+
+    func mapPoints(origin: MKMapPoint) -> [MKMapPoint] {
+        var points: [MKMapPoint] = []
+        points.reserveCapacity(count)
+
+        forEachVertex { x, y in
+            points.append(MKMapPoint(x: origin.x + x / QuantizedPath.unitsPerMapPoint, y: origin.y + y / QuantizedPath.unitsPerMapPoint))
+        }
+
+        return points
+    }
+}
@@ -0,0 +1,106 @@
+//
+//  SpatialGrid.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+
+// Uniform grid over map rects. Every item is stored in each cell its rect overlaps,
+// so point queries cost one cell lookup and rect queries may report an item more than once.
+// Only cells holding items are stored, so the bounds may be far larger than the area the items cover,
+// as with one floor of a tiled synthetic venue.
+struct SpatialGrid {
+    private let origin: MKMapPoint
+    private let cellSize: Double
+    private let columns: Int
+    private let rows: Int
+    private var cells: [Int: [Int]] = [:] // by row * columns + column
+
+    init(bounds: MKMapRect, cellSize: Double, items: [(index: Int, rect: MKMapRect)]) {
+        self.origin = bounds.origin
+        self.cellSize = cellSize
+        self.columns = max(1, Int((bounds.size.width / cellSize).rounded(.up)))
+        self.rows = max(1, Int((bounds.size.height / cellSize).rounded(.up)))
+
+        for item in items {
+            guard let range = cellRange(of: item.rect) else { continue }
+
+            for row in range.rows {
+                for column in range.columns {
+                    cells[row * columns + column, default: []].append(item.index)
+                }
+            }
+        }
+    }
+
+    func items(at point: MKMapPoint) -> [Int] {
+        let column = Int(((point.x - origin.x) / cellSize).rounded(.down))
+        let row = Int(((point.y - origin.y) / cellSize).rounded(.down))
+        guard column >= 0, column < columns, row >= 0, row < rows else { return [] }
+
+        return cells[row * columns + column] ?? []
+    }
+
+    // Approximate memory used by the cells, in bytes
+    var byteCount: Int {
+        return cells.values.reduce(cells.count * (MemoryLayout<Int>.stride + MemoryLayout<[Int]>.stride)) {
+            $0 + $1.count * MemoryLayout<Int>.stride
+        }
+    }
+
+    // The `count` items nearest to the point by `distance`. The searched square grows until it holds that many
+    // items no farther than its half width, or covers the whole grid.
+    func nearestItems(to point: MKMapPoint, count: Int, distance: (Int) -> Double) -> [Int] {
+        guard count > 0 else { return [] }
+
+        let gridRect = MKMapRect(x: origin.x, y: origin.y, width: Double(columns) * cellSize, height: Double(rows) * cellSize)
+        var radius = cellSize
+
+        while true {
+            let rect = MKMapRect(x: point.x - radius, y: point.y - radius, width: 2 * radius, height: 2 * radius)
+            var seen = Set<Int>()
+            var candidates: [(item: Int, distance: Double)] = []
+
+            forEachItem(in: rect) { item in
+                if seen.insert(item).inserted {
+                    candidates.append((item, distance(item)))
+                }
+            }
+
+            if rect.contains(gridRect) || candidates.filter({ $0.distance <= radius }).count >= count {
+                return candidates.sorted { $0.distance < $1.distance }.prefix(count).map { $0.item }
+            }
+            radius *= 2
+        }
+    }
+
+    func forEachItem(in rect: MKMapRect, _ body: (Int) -> Void) {
+        guard let range = cellRange(of: rect) else { return }
+
+        // A rect spanning more cells than are stored is served from the stored cells
+        if range.rows.count * range.columns.count > cells.count {
+            for (cell, items) in cells where range.rows.contains(cell / columns) && range.columns.contains(cell % columns) {
+                items.forEach(body)
+            }
+            return
+        }
+
+        for row in range.rows {
+            for column in range.columns {
+                cells[row * columns + column]?.forEach(body)
+            }
+        }
+    }
+
+    private func cellRange(of rect: MKMapRect) -> (columns: ClosedRange<Int>, rows: ClosedRange<Int>)? {
+        let minColumn = max(0, Int(((rect.minX - origin.x) / cellSize).rounded(.down)))
+        let maxColumn = min(columns - 1, Int(((rect.maxX - origin.x) / cellSize).rounded(.down)))
+        let minRow = max(0, Int(((rect.minY - origin.y) / cellSize).rounded(.down)))
+        let maxRow = min(rows - 1, Int(((rect.maxY - origin.y) / cellSize).rounded(.down)))
+        guard minColumn <= maxColumn, minRow <= maxRow else { return nil }
+
+        return (minColumn...maxColumn, minRow...maxRow)
+    }
+}
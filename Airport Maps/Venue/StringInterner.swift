@@ -0,0 +1,45 @@
+//
+//  StringInterner.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import Foundation
+
+// Table of distinct strings, such as the category names of a venue. Every distinct string is stored once
+// and referred to by a small identifier, so repeated values compare and hash as integers and copies of an
+// interned string share its storage. Not thread safe, each owner keeps its own table.
+final class StringInterner {
+    private(set) var strings: [String] = []
+    private var identifiers: [String: Int32] = [:]
+
+    var count: Int {
+        return strings.count
+    }
+
+    var byteCount: Int {
+        return strings.reduce(strings.count * (MemoryLayout<String>.stride * 2 + MemoryLayout<Int32>.stride)) { $0 + $1.utf8.count }
+    }
+
+    func intern(_ string: String) -> Int32 {
+        if let identifier = identifiers[string] {
+            return identifier
+        }
+
+        let identifier = Int32(strings.count)
+        strings.append(string)
+        identifiers[string] = identifier
+
+        return identifier
+    }
+
+    // The stored copy of the string, callers keep it instead of their own copy
+    func interned(_ string: String) -> String {
+        return strings[Int(intern(string))]
+    }
+
+    func string(for identifier: Int32) -> String {
+        return strings[Int(identifier)]
+    }
+}
@@ -0,0 +1,326 @@
+//
+//  SyntheticVenue.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+#if DEBUG
+import Foundation
+import os.log
+
+// Writes a larger venue directory by tiling a real one, for benchmarks beyond the size of one airport.
+// Copies are laid out in a grid next to each other and stacked on top of each other, so the geometry
+// stays realistic and stacked connectors line up. Every identifier of a copy is rewritten the same way in
+// all files, which keeps the references between layers valid. Works on AVF and IMDF directories alike.
+// AVF copies can get extra occupants with categories drawn from CategoryKeywords.txt, weighted by how often
+// the source venue uses them. The output only depends on the source and the configuration.
+enum SyntheticVenue {
+    struct Configuration {
+        var columns = 1
+        var rows = 1
+        var stacks = 1 // copies on top of each other, each above the ordinals of the one below
+        var copyLimit: Int? // lays out only this many copies, filling the grid row by row
+        var extraOccupantsPerCopy = 0
+        var seed: UInt64 = 1
+
+        var copyCount: Int {
+            return min(columns * rows * stacks, copyLimit ?? .max)
+        }
+
+        // Exactly `factor` times the source venue, on a near square grid of one stack whose last row may be partly filled
+        init(scale factor: Int, seed: UInt64 = 1) {
+            self.columns = max(Int(Double(factor).squareRoot().rounded(.up)), 1)
+            self.rows = max((factor + columns - 1) / columns, 1)
+            self.copyLimit = max(factor, 1)
+            self.seed = seed
+        }
+
+        init() {
+        }
+    }
+
+    enum GenerationError: Error {
+        case unreadableFile(String)
+        case missingVenue
+    }
+
+    private struct Copy {
+        let index: Int
+        let dx: Double // degrees
+        let dy: Double
+        let ordinalOffset: Int
+    }
+
+    // Keys of references to files that are not tiled, they keep pointing to the single copy
+    private static let sharedReferenceKeys = ["ADDRESS_ID", "address_id"]
+
+    static func generate(from sourcePath: String, to destinationPath: String, configuration: Configuration) throws {
+        let fileManager = FileManager.default
+        try? fileManager.removeItem(atPath: destinationPath)
+        try fileManager.createDirectory(atPath: destinationPath, withIntermediateDirectories: true)
+
+        var layers: [String: [[String: Any]]] = [:]
+        for fileName in try fileManager.contentsOfDirectory(atPath: sourcePath) {
+            let path = (sourcePath as NSString).appendingPathComponent(fileName)
+
+            guard fileName.hasSuffix(".geojson") else {
+                try fileManager.copyItem(atPath: path, toPath: (destinationPath as NSString).appendingPathComponent(fileName))
+                continue
+            }
+
+            guard let data = fileManager.contents(atPath: path),
+                  let object = try? JSONSerialization.jsonObject(with: data) as? [String: Any],
+                  let features = object["features"] as? [[String: Any]] else {
+                throw GenerationError.unreadableFile(fileName)
+            }
+            layers[fileName] = features
+        }
+
+        guard let venueFileName = layers.keys.first(where: { $0.lowercased() == "venue.geojson" }),
+              let bounds = boundingBox(of: layers[venueFileName]!.map { $0["geometry"] as Any }) else {
+            throw GenerationError.missingVenue
+        }
+
+        let identifiers = collectIdentifiers(in: layers.values.joined())
+        let ordinals = layers.values.joined().compactMap { ordinal(of: $0) }
+        let ordinalSpan = (ordinals.max() ?? 0) - (ordinals.min() ?? 0) + 1
+
+        // A small gap between copies keeps their units from touching
+        let width = (bounds.maxX - bounds.minX) * 1.05, height = (bounds.maxY - bounds.minY) * 1.05
+        var copies: [Copy] = []
+        for stack in 0..<configuration.stacks {
+            for row in 0..<configuration.rows {
+                for column in 0..<configuration.columns where copies.count < configuration.copyCount {
+                    copies.append(Copy(index: copies.count, dx: Double(column) * width, dy: Double(row) * height,
+                                       ordinalOffset: stack * ordinalSpan))
+                }
+            }
+        }
+
+        var generator = SplitMix64(seed: configuration.seed)
+        let occupantCategories = self.occupantCategories(sourcePath: sourcePath, occupants: layers["Occupants.geojson"] ?? [])
+
+        for (fileName, features) in layers {
+            var copiedFeatures: [[String: Any]] = []
+
+            if fileName == venueFileName {
+                // One venue whose outline covers every copy
+                var venue = features[0]
+                let polygons = copies.flatMap { copy in
+                    features.flatMap { polygonsCoordinates(of: offset($0["geometry"] as Any, by: copy)) }
+                }
+                venue["geometry"] = ["type": "MultiPolygon", "coordinates": polygons]
+                copiedFeatures = [venue]
+            } else {
+                for copy in copies {
+                    copiedFeatures.append(contentsOf: features.map { self.copy($0, as: copy, identifiers: identifiers) })
+                }
+            }
+
+            if fileName == "Occupants.geojson", configuration.extraOccupantsPerCopy > 0, !occupantCategories.isEmpty {
+                let rooms = (layers["Units.geojson"] ?? []).filter { ($0["properties"] as? [String: Any])?["CATEGORY"] as? String == "Room" }
+
+                for copy in copies where !rooms.isEmpty {
+                    for number in 0..<configuration.extraOccupantsPerCopy {
+                        let room = self.copy(rooms[Int.random(in: 0..<rooms.count, using: &generator)], as: copy, identifiers: identifiers)
+                        let category = weightedCategory(occupantCategories, using: &generator)
+
+                        copiedFeatures.append(syntheticOccupant(in: room, category: category, number: copy.index * configuration.extraOccupantsPerCopy + number))
+                    }
+                }
+            }
+
+            // Sorted keys, so the same source and configuration write the same bytes
+            let data = try JSONSerialization.data(withJSONObject: ["type": "FeatureCollection", "features": copiedFeatures],
+                                                  options: [.sortedKeys])
+            try data.write(to: URL(fileURLWithPath: (destinationPath as NSString).appendingPathComponent(fileName)))
+        }
+
+        os_log("Wrote %ld copies of %{public}@ to %{public}@", type: .info, copies.count, sourcePath, destinationPath)
+    }
+
+    private static func copy(_ feature: [String: Any], as copy: Copy, identifiers: Set<String>) -> [String: Any] {
+        var feature = feature
+
+        if let identifier = feature["id"] as? String {
+            feature["id"] = rewrite(identifier, copy: copy, identifiers: identifiers)
+        }
+        if let geometry = feature["geometry"], !(geometry is NSNull) {
+            feature["geometry"] = offset(geometry, by: copy)
+        }
+        if var properties = feature["properties"] as? [String: Any] {
+            for (key, value) in properties where !sharedReferenceKeys.contains(key) {
+                properties[key] = rewriteProperty(value, copy: copy, identifiers: identifiers)
+            }
+            for key in ["ORDINAL", "ordinal"] {
+                if let ordinal = properties[key] as? Int {
+                    properties[key] = ordinal + copy.ordinalOffset
+                }
+            }
+            feature["properties"] = properties
+        }
+
+        return feature
+    }
+
+    private static func rewriteProperty(_ value: Any, copy: Copy, identifiers: Set<String>) -> Any {
+        if let string = value as? String {
+            return rewrite(string, copy: copy, identifiers: identifiers)
+        } else if let array = value as? [Any] {
+            return array.map { rewriteProperty($0, copy: copy, identifiers: identifiers) }
+        } else if let dictionary = value as? [String: Any] {
+            // Display points are geometries inside the properties
+            if dictionary["coordinates"] != nil {
+                return offset(dictionary, by: copy)
+            }
+            return dictionary.mapValues { rewriteProperty($0, copy: copy, identifiers: identifiers) }
+        }
+
+        return value
+    }
+
+    // The first copy keeps the source identifiers; UUIDs stay UUIDs, as IMDF requires
+    private static func rewrite(_ string: String, copy: Copy, identifiers: Set<String>) -> String {
+        guard copy.index > 0, identifiers.contains(string) else { return string }
+
+        if let uuid = UUID(uuidString: string) {
+            var bytes = uuid.uuid
+            bytes.14 ^= UInt8(truncatingIfNeeded: copy.index >> 8)
+            bytes.15 ^= UInt8(truncatingIfNeeded: copy.index)
+
+            return UUID(uuid: bytes).uuidString.lowercased()
+        }
+
+        return "\(string)-\(copy.index)"
+    }
+
+    private static func offset(_ geometry: Any, by copy: Copy) -> Any {
+        if var dictionary = geometry as? [String: Any] {
+            if let coordinates = dictionary["coordinates"] {
+                dictionary["coordinates"] = offsetCoordinates(coordinates, dx: copy.dx, dy: copy.dy)
+            }
+            return dictionary
+        }
+
+        return geometry
+    }
+
+    private static func offsetCoordinates(_ coordinates: Any, dx: Double, dy: Double) -> Any {
+        if let position = coordinates as? [Double], position.count >= 2 {
+            return [position[0] + dx, position[1] + dy] + position.dropFirst(2)
+        } else if let nested = coordinates as? [Any] {
+            return nested.map { offsetCoordinates($0, dx: dx, dy: dy) }
+        }
+
+        return coordinates
+    }
+
+    private static func polygonsCoordinates(of geometry: Any) -> [Any] {
+        guard let dictionary = geometry as? [String: Any], let coordinates = dictionary["coordinates"] as? [Any] else { return [] }
+
+        switch dictionary["type"] as? String {
+        case "Polygon":
+            return [coordinates]
+        case "MultiPolygon":
+            return coordinates
+        default:
+            return []
+        }
+    }
+
+    private static func boundingBox(of geometries: [Any]) -> (minX: Double, minY: Double, maxX: Double, maxY: Double)? {
+        var box: (minX: Double, minY: Double, maxX: Double, maxY: Double)?
+
+        func visit(_ coordinates: Any) {
+            if let position = coordinates as? [Double], position.count >= 2 {
+                let current = box ?? (position[0], position[1], position[0], position[1])
+                box = (min(current.minX, position[0]), min(current.minY, position[1]),
+                       max(current.maxX, position[0]), max(current.maxY, position[1]))
+            } else if let nested = coordinates as? [Any] {
+                nested.forEach(visit)
+            }
+        }
+
+        for geometry in geometries {
+            if let coordinates = (geometry as? [String: Any])?["coordinates"] {
+                visit(coordinates)
+            }
+        }
+
+        return box
+    }
+
+    // Feature ids and the values of identifier properties, so references are rewritten along with what they point to
+    private static func collectIdentifiers<S: Sequence>(in features: S) -> Set<String> where S.Element == [String: Any] {
+        var identifiers = Set<String>()
+
+        for feature in features {
+            if let identifier = feature["id"] as? String {
+                identifiers.insert(identifier)
+            }
+            for (key, value) in feature["properties"] as? [String: Any] ?? [:]
+                where key.uppercased().hasSuffix("ID") && !sharedReferenceKeys.contains(key) {
+                if let string = value as? String, !string.isEmpty {
+                    identifiers.insert(string)
+                }
+            }
+        }
+
+        return identifiers
+    }
+
+    private static func ordinal(of feature: [String: Any]) -> Int? {
+        let properties = feature["properties"] as? [String: Any]
+
+        return properties?["ORDINAL"] as? Int ?? properties?["ordinal"] as? Int
+    }
+
+    // Categories of CategoryKeywords.txt with the number of source occupants using them, at least one each
+    private static func occupantCategories(sourcePath: String, occupants: [[String: Any]]) -> [(category: String, weight: Int)] {
+        let path = (sourcePath as NSString).appendingPathComponent("CategoryKeywords.txt")
+        guard let data = FileManager.default.contents(atPath: path),
+              let entries = try? JSONSerialization.jsonObject(with: data) as? [[String: Any]] else { return [] }
+
+        var counts: [String: Int] = [:]
+        for occupant in occupants {
+            if let category = (occupant["properties"] as? [String: Any])?["CATEGORY"] as? String {
+                counts[category, default: 0] += 1
+            }
+        }
+
+        return entries.compactMap { $0["cat"] as? String }.map { ($0, 1 + (counts[$0] ?? 0)) }
+    }
+
+    private static func weightedCategory(_ categories: [(category: String, weight: Int)], using generator: inout SplitMix64) -> String {
+        var remaining = Int.random(in: 0..<categories.reduce(0) { $0 + $1.weight }, using: &generator)
+        for entry in categories {
+            remaining -= entry.weight
+            if remaining < 0 {
+                return entry.category
+            }
+        }
+
+        return categories[categories.count - 1].category
+    }
+
+    // An AVF occupant at the vertex centroid of the room's first ring
+    private static func syntheticOccupant(in room: [String: Any], category: String, number: Int) -> [String: Any] {
+        var points: [[Double]] = []
+        if let geometry = room["geometry"], let ring = polygonsCoordinates(of: geometry).first as? [Any] {
+            points = (ring.first as? [[Double]]) ?? []
+        }
+        let x = points.reduce(0) { $0 + $1[0] } / Double(max(points.count, 1))
+        let y = points.reduce(0) { $0 + $1[1] } / Double(max(points.count, 1))
+
+        let properties: [String: Any] = [
+            "OCCU_ID": String(format: "synthetic-occupant-%06d", number),
+            "LEVEL_ID": (room["properties"] as? [String: Any])?["LEVEL_ID"] ?? NSNull(),
+            "CATEGORY": category,
+            "NAME": "\(category) \(number)"
+        ]
+
+        return ["type": "Feature", "properties": properties, "geometry": ["type": "Point", "coordinates": [x, y]]]
+    }
+}
+#endif
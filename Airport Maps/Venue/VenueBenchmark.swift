@@ -0,0 +1,321 @@
+//
+//  VenueBenchmark.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+#if DEBUG
+import MapKit
+import QuartzCore
+import os.log
+
+// Repeatable timings of a bundled venue: loading per layer, hit testing, containment, search per prefix length,
+// app side routing, floor switching, and styling and labeling the largest floor. Query points and search strings come from a seeded generator, so two runs
+// over the same data measure the same work.
+// Run the app with the `-VenueBenchmark` launch argument to write VenueBenchmark-<venue>.json to the documents directory.
+// With `-VenueBenchmarkBaseline <directory>` the results are compared against earlier ones and regressions are logged.
+// With `-VenueBenchmarkScales 10,100` tiled copies of the venues that many times larger are benchmarked as well.
+// Styling and labeling also count their reads of the manager's string accessors, each of which allocates a string.
+// All methods must be called on the main queue.
+final class VenueBenchmark {
+    struct Measurement: Codable {
+        let name: String
+        let count: Int
+        let p50: Double // milliseconds
+        let p90: Double
+        let p99: Double
+        let max: Double
+    }
+
+    struct Report: Codable {
+        let venue: String
+        let seed: UInt64
+        let measurements: [Measurement]
+        let allocations: [String: Int]? // allocating accessor reads per pass
+    }
+
+    // A median this much slower than the baseline is a regression
+    static let regressionThreshold = 1.2
+
+    let venueName: String
+    let directoryPath: String
+    let seed: UInt64
+    let sampleCount: Int
+
+    private static var running: VenueBenchmark?
+
+    private let mapManager = PC_IndoorMapManager()
+    private var samples: [String: [Double]] = [:]
+    private var allocations: [String: Int] = [:]
+    private var features: [PC_IndoorMapFeature] = []
+
+    init(venueName: String, directoryPath: String, seed: UInt64 = 1, sampleCount: Int = 1000) {
+        self.venueName = venueName
+        self.directoryPath = directoryPath
+        self.seed = seed
+        self.sampleCount = sampleCount
+    }
+
+    func run(completion: @escaping (Report) -> Void) {
+        var layerDurations: [String: Double] = [:]
+        var features: [PC_IndoorMapFeature] = []
+        var lastTime = CACurrentMediaTime()
+        let startTime = lastTime
+
+        // The time between two loaded features is charged to the layer of the second one
+        let onFeatureLoad: (PC_IndoorMapFeature, UnsafeMutablePointer<ObjCBool>, UnsafeMutablePointer<ObjCBool>) -> Void = { feature, _, _ in
+            let now = CACurrentMediaTime()
+            layerDurations[feature.layer.name, default: 0] += now - lastTime
+            lastTime = now
+            features.append(feature)
+        }
+
+        mapManager.loadVenueFromDirectory(atPath: directoryPath, options: [], onFeatureLoad: onFeatureLoad) { [weak self] finished in
+            guard let strongSelf = self else { return }
+
+            strongSelf.record("load", CACurrentMediaTime() - startTime)
+            for (layerName, duration) in layerDurations {
+                strongSelf.record("load.\(layerName)", duration)
+            }
+            strongSelf.features = features
+
+            let geometryStartTime = CACurrentMediaTime()
+            guard finished, let geometry = VenueGeometry(directoryPath: strongSelf.directoryPath) else {
+                os_log("Benchmark could not load %{public}@", type: .error, strongSelf.venueName)
+                completion(strongSelf.report())
+                return
+            }
+            strongSelf.record("load.geometry", CACurrentMediaTime() - geometryStartTime)
+
+            strongSelf.runQueries(geometry: geometry)
+            completion(strongSelf.report())
+        }
+    }
+
+    private func runQueries(geometry: VenueGeometry) {
+        var generator = SplitMix64(seed: seed)
+        let rect = geometry.limitRect
+        let ordinalValues = geometry.ordinalValues
+
+        func randomLocation() -> (mapPoint: MKMapPoint, ordinalValue: Int) {
+            let mapPoint = MKMapPoint(x: Double.random(in: rect.minX..<rect.maxX, using: &generator),
+                                      y: Double.random(in: rect.minY..<rect.maxY, using: &generator))
+
+            return (mapPoint, ordinalValues.randomElement(using: &generator) ?? 0)
+        }
+
+        for _ in 0..<sampleCount {
+            let point = randomLocation()
+            let location = PC_IndoorMapLocation(mapPoint: point.mapPoint, ordinalValue: point.ordinalValue)
+
+            measure("enumerateFeaturesAtLocation") {
+                mapManager.enumerateFeatures(at: location) { _, _ in }
+            }
+            measure("geometry.unitIndex") {
+                _ = geometry.unitIndex(containing: point.mapPoint, ordinalValue: point.ordinalValue)
+            }
+            measure("geometry.isInsideVenue") {
+                _ = geometry.isInsideVenue(point.mapPoint)
+            }
+        }
+
+        let units = features.filter { $0.layer.layerType == .units }
+        if !units.isEmpty {
+            for _ in 0..<sampleCount {
+                let unit = units[Int.random(in: 0..<units.count, using: &generator)]
+                let point = randomLocation()
+
+                measure("containsPoint") {
+                    _ = unit.contains(point.mapPoint)
+                }
+            }
+        }
+
+        // Prefixes are taken from the names the library searches, NAME for AVF and the mapped IMDF name
+        let names = features.compactMap { $0.nameOrShortName }.filter { $0.count >= 6 }
+        if !names.isEmpty {
+            for prefixLength in 3...6 {
+                for _ in 0..<sampleCount / 10 {
+                    let prefix = String(names[Int.random(in: 0..<names.count, using: &generator)].prefix(prefixLength))
+
+                    measure("searchString.\(prefixLength)") {
+                        _ = mapManager.searchString(prefix, inField: "NAME", location: nil)
+                    }
+                }
+            }
+        }
+
+        measure("openingAdjacency") {
+            _ = OpeningAdjacency(geometry: geometry)
+        }
+
+        let graphStartTime = CACurrentMediaTime()
+        let graph = NavigationGraph(geometry: geometry)
+        record("navigationGraph", CACurrentMediaTime() - graphStartTime)
+
+        for _ in 0..<sampleCount / 10 {
+            let start = randomLocation(), end = randomLocation()
+
+            measure("route") {
+                _ = graph.route(from: start.mapPoint, fromOrdinalValue: start.ordinalValue, to: end.mapPoint,
+                                toOrdinalValue: end.ordinalValue, profile: .standard)
+            }
+        }
+
+        for _ in 0..<sampleCount / 10 {
+            let ordinalValue = ordinalValues.randomElement(using: &generator) ?? 0
+
+            measure("ordinalSwitch") {
+                mapManager.ordinalValue = ordinalValue
+            }
+        }
+
+        runStyling()
+    }
+
+    // Styles and labels every feature of the floor with the most features, the work of showing that floor
+    private func runStyling() {
+        let featuresByOrdinal = Dictionary(grouping: features.filter { $0.location != nil }) { $0.location!.ordinalValue }
+        guard let ordinalFeatures = featuresByOrdinal.values.max(by: { $0.count < $1.count }) else { return }
+
+        for _ in 0..<sampleCount / 100 {
+            let mapStyle = MapStyle(resource: "Maps/MapStyleSheet")
+
+            measure("style.cold") {
+                for feature in ordinalFeatures {
+                    _ = mapStyle.renderer(for: feature)
+                }
+            }
+            let coldReadCount = mapStyle.propertyReadCount
+
+            measure("style.warm") {
+                for feature in ordinalFeatures {
+                    _ = mapStyle.renderer(for: feature)
+                }
+            }
+            allocations["style.cold"] = coldReadCount
+            allocations["style.warm"] = mapStyle.propertyReadCount - coldReadCount
+        }
+
+        // Labels are placed once per distinct name, read through the accessor or from the interned copies
+        let titles = StringInterner()
+        let titleIDs = ordinalFeatures.map { feature in feature.nameOrShortName.map(titles.intern) ?? -1 }
+
+        for _ in 0..<sampleCount / 100 {
+            measure("label.accessor") {
+                var placed = Set<String>()
+                for feature in ordinalFeatures {
+                    if let title = feature.nameOrShortName {
+                        placed.insert(title)
+                    }
+                }
+            }
+            measure("label.interned") {
+                var placed = Set<Int32>()
+                for titleID in titleIDs where titleID >= 0 {
+                    placed.insert(titleID)
+                }
+            }
+        }
+        allocations["label.accessor"] = ordinalFeatures.count
+        allocations["label.interned"] = 0
+    }
+
+    private func measure(_ name: String, _ body: () -> Void) {
+        let startTime = CACurrentMediaTime()
+        body()
+        record(name, CACurrentMediaTime() - startTime)
+    }
+
+    private func record(_ name: String, _ duration: TimeInterval) {
+        samples[name, default: []].append(duration * 1000)
+    }
+
+    private func report() -> Report {
+        let measurements = samples.keys.sorted().map { name -> Measurement in
+            let values = samples[name]!.sorted()
+            func percentile(_ p: Double) -> Double {
+                return values[min(Int(p * Double(values.count)), values.count - 1)]
+            }
+
+            return Measurement(name: name, count: values.count, p50: percentile(0.5), p90: percentile(0.9),
+                               p99: percentile(0.99), max: values[values.count - 1])
+        }
+
+        return Report(venue: venueName, seed: seed, measurements: measurements, allocations: allocations)
+    }
+
+    // Names of the measurements whose median regressed against the baseline
+    static func regressions(of report: Report, baseline: Report) -> [String] {
+        let baselineMedians = Dictionary(baseline.measurements.map { ($0.name, $0.p50) }, uniquingKeysWith: { first, _ in first })
+
+        return report.measurements.filter { measurement in
+            guard let median = baselineMedians[measurement.name], median > 0 else { return false }
+
+            return measurement.p50 > median * regressionThreshold
+        }.map { $0.name }
+    }
+
+    // Benchmarks the bundled venues, and their synthetic copies at each scale, one after the other,
+    // writes the reports and logs regressions
+    static func runBundledVenues(baselineDirectory: URL?, scales: [Int] = []) {
+        guard let resourceURL = Bundle.main.resourceURL,
+              let documentsURL = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first,
+              let cachesURL = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first else { return }
+
+        let sourceNames = ["AVF/AMS", "IMDF/AMS"]
+        var venues = sourceNames.map { (name: $0, path: resourceURL.appendingPathComponent("Maps/\($0)").path) }
+
+        for scale in scales where scale > 1 {
+            for sourceName in sourceNames {
+                let name = "\(sourceName)x\(scale)"
+                let path = cachesURL.appendingPathComponent("SyntheticVenues/\(name)").path
+
+                do {
+                    try SyntheticVenue.generate(from: resourceURL.appendingPathComponent("Maps/\(sourceName)").path, to: path,
+                                                configuration: SyntheticVenue.Configuration(scale: scale))
+                    venues.append((name, path))
+                } catch {
+                    os_log("Could not generate %{public}@: %{public}@", type: .error, name, error.localizedDescription)
+                }
+            }
+        }
+
+        func runNext() {
+            guard !venues.isEmpty else {
+                running = nil
+                return
+            }
+
+            let (venueName, directoryPath) = venues.removeFirst()
+            let benchmark = VenueBenchmark(venueName: venueName, directoryPath: directoryPath)
+            running = benchmark
+            benchmark.run { report in
+                let fileName = "VenueBenchmark-\(venueName.replacingOccurrences(of: "/", with: "-")).json"
+                let encoder = JSONEncoder()
+                encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+
+                if let data = try? encoder.encode(report) {
+                    try? data.write(to: documentsURL.appendingPathComponent(fileName))
+                }
+
+                if let baselineURL = baselineDirectory?.appendingPathComponent(fileName),
+                   let data = try? Data(contentsOf: baselineURL),
+                   let baseline = try? JSONDecoder().decode(Report.self, from: data) {
+                    let regressions = VenueBenchmark.regressions(of: report, baseline: baseline)
+                    os_log("Benchmark %{public}@: %ld regressions %{public}@", type: regressions.isEmpty ? .info : .error,
+                           venueName, regressions.count, regressions.joined(separator: ", "))
+                } else {
+                    os_log("Benchmark %{public}@: %ld measurements written to %{public}@", type: .info,
+                           venueName, report.measurements.count, fileName)
+                }
+
+                DispatchQueue.main.async(execute: runNext)
+            }
+        }
+
+        runNext()
+    }
+}
+#endif
@@ -0,0 +1,105 @@
+//
+//  VenueDelta.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import Foundation
+
+// Feature level changes to a loaded venue, keyed by the identifier of the feature in its own layer
+// (OCCU_ID, POINT_ID, UNIT_ID and so on) or the IMDF `id`, see `ResidentVenue.identifier(of:)`.
+// Example:
+//     {
+//       "removed": ["OCCU_0042"],
+//       "modified": [{ "id": "POINT_0107", "title": "Gate D7", "subtitle": "Closed" }],
+//       "added": ["OCCU_0301"]
+//     }
+struct VenueDelta: Decodable {
+    struct Modification: Decodable {
+        let id: String
+        let title: String?
+        let subtitle: String?
+    }
+
+    struct Result {
+        // Features whose map objects were invalidated
+        let touchedFeatures: [PC_IndoorMapFeature]
+        let missingIdentifiers: [String]
+
+        // Added features only appear after the venue directory is loaded again
+        let needsReload: Bool
+    }
+
+    var removed: [String] = []
+    var modified: [Modification] = []
+    var added: [String] = []
+
+    init(contentsOf url: URL) throws {
+        self = try JSONDecoder().decode(VenueDelta.self, from: Data(contentsOf: url))
+    }
+
+    private enum CodingKeys: String, CodingKey {
+        case removed, modified, added
+    }
+
+    init(from decoder: Decoder) throws {
+        let container = try decoder.container(keyedBy: CodingKeys.self)
+
+        removed = try container.decodeIfPresent([String].self, forKey: .removed) ?? []
+        modified = try container.decodeIfPresent([Modification].self, forKey: .modified) ?? []
+        added = try container.decodeIfPresent([String].self, forKey: .added) ?? []
+    }
+}
+
+extension ResidentVenue {
+    // Applies the delta to the loaded features and refreshes the map objects of the touched features only.
+    // Removed features stay in the manager but are no longer drawn, see `isFeatureRemoved(_:)`. Removed units
+    // and openings are closed in the route planner, so the planned routes through them are calculated again.
+    func apply(_ delta: VenueDelta) -> VenueDelta.Result {
+        var touchedFeatures: [PC_IndoorMapFeature] = []
+        var missingIdentifiers: [String] = []
+
+        for identifier in delta.removed {
+            guard let feature = featuresByIdentifier[identifier] else {
+                missingIdentifiers.append(identifier)
+                continue
+            }
+
+            markFeatureRemoved(feature)
+            if feature.layer.layerType == .units || feature.layer.layerType == .openings {
+                routePlanner?.setOverride(.closed, forFeatureIdentifier: identifier)
+            }
+            feature.title = nil
+            feature.subtitle = nil
+            touchedFeatures.append(feature)
+        }
+
+        for modification in delta.modified {
+            guard let feature = featuresByIdentifier[modification.id] else {
+                missingIdentifiers.append(modification.id)
+                continue
+            }
+
+            if let title = modification.title {
+                feature.title = title
+            }
+            if let subtitle = modification.subtitle {
+                feature.subtitle = subtitle
+            }
+            touchedFeatures.append(feature)
+        }
+
+        if !touchedFeatures.isEmpty {
+            mapManager.invalidateMapObjects(with: touchedFeatures)
+            invalidateFeatureCaches()
+
+            if snapshotPublisher.current != nil {
+                publishSnapshot()
+            }
+        }
+
+        return VenueDelta.Result(touchedFeatures: touchedFeatures, missingIdentifiers: missingIdentifiers,
+                                 needsReload: delta.added.contains { featuresByIdentifier[$0] == nil })
+    }
+}
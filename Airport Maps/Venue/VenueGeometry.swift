@@ -0,0 +1,592 @@
+//
+//  VenueGeometry.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+
+// Levels, units and openings of an AVF venue directory or an IMDF archive, projected to map points.
+// PC_IndoorMapManager keeps its geometry private, so spatial queries made by the app
+// (location filtering for instance) run against this copy.
+public final class VenueGeometry {
+    public struct Polygon {
+        public let boundingRect: MKMapRect
+
+        // The first ring is the exterior, the following rings are holes,
+        // stored relative to the bounding rect origin
+        private let quantizedRings: [QuantizedPath]
+
+        init(rings: [[MKMapPoint]], boundingRect: MKMapRect) {
+            self.boundingRect = boundingRect
+            self.quantizedRings = rings.map { QuantizedPath(points: $0, origin: boundingRect.origin) }
+        }
+
+        // Decoded rings, meant for building indices rather than for per-point queries
+        public var rings: [[MKMapPoint]] {
+            return quantizedRings.map { $0.mapPoints(origin: boundingRect.origin) }
+        }
+
+        public var vertexCount: Int {
+            return quantizedRings.reduce(0) { $0 + $1.count }
+        }
+
+        public var byteCount: Int {
+            return quantizedRings.reduce(MemoryLayout<Polygon>.stride) { $0 + $1.byteCount + MemoryLayout<QuantizedPath>.stride }
+        }
+
+        public func contains(_ point: MKMapPoint) -> Bool {
+            guard boundingRect.contains(point) else { return false }
+
+            // The test runs in quantized units, so vertices are used as decoded
+            let px = (point.x - boundingRect.origin.x) * QuantizedPath.unitsPerMapPoint
+            let py = (point.y - boundingRect.origin.y) * QuantizedPath.unitsPerMapPoint
+
+            var inside = false
+            for ring in quantizedRings {
+                var isFirst = true
+                var firstX = 0.0, firstY = 0.0, previousX = 0.0, previousY = 0.0
+
+                func test(_ x: Double, _ y: Double) {
+                    if (y > py) != (previousY > py), px < (previousX - x) * (py - y) / (previousY - y) + x {
+                        inside.toggle()
+                    }
+                    previousX = x
+                    previousY = y
+                }
+
+                ring.forEachVertex { x, y in
+                    if isFirst {
+                        isFirst = false
+                        firstX = x
+                        firstY = y
+                        previousX = x
+                        previousY = y
+                        return
+                    }
+                    test(x, y)
+                }
+
+                // Closing edge, degenerate when the ring repeats its first vertex
+                if !isFirst {
+                    test(firstX, firstY)
+                }
+            }
+
+            return inside
+        }
+    }
+
+    public struct Level {
+        public let identifier: String
+        public let ordinalValue: Int
+        public let polygons: [Polygon]
+    }
+
+    public struct Unit {
+        public let identifier: String
+        public let category: String
+        public let ordinalValue: Int
+        public let polygons: [Polygon]
+        public let boundingRect: MKMapRect
+
+        // Stairs, escalators and elevators, the only places where the floor can change
+        public var isVerticalConnector: Bool {
+            return category.contains("Stairs") || category.contains("Escalator") || category.contains("Elevator")
+        }
+
+        public var isWalkable: Bool {
+            return category != "Open to Below"
+        }
+
+        public func contains(_ point: MKMapPoint) -> Bool {
+            return boundingRect.contains(point) && polygons.contains { $0.contains(point) }
+        }
+
+        init?(identifier: String, category: String, ordinalValue: Int, geometry: Any?) {
+            let polygons = VenueGeometry.polygons(of: geometry)
+            guard let first = polygons.first else { return nil }
+
+            self.identifier = identifier
+            self.category = category
+            self.ordinalValue = ordinalValue
+            self.polygons = polygons
+            self.boundingRect = polygons.dropFirst().reduce(first.boundingRect) { $0.union($1.boundingRect) }
+        }
+    }
+
+    public struct Opening {
+        public let identifier: String
+        public let ordinalValue: Int
+        public let boundingRect: MKMapRect
+
+        // Stored relative to the bounding rect origin
+        private let quantizedLines: [QuantizedPath]
+
+        init(identifier: String, ordinalValue: Int, lines: [[MKMapPoint]]) {
+            let boundingRect = VenueGeometry.boundingRect(of: lines.joined())
+
+            self.identifier = identifier
+            self.ordinalValue = ordinalValue
+            self.boundingRect = boundingRect
+            self.quantizedLines = lines.map { QuantizedPath(points: $0, origin: boundingRect.origin) }
+        }
+
+        public var lines: [[MKMapPoint]] {
+            return quantizedLines.map { $0.mapPoints(origin: boundingRect.origin) }
+        }
+
+        public var byteCount: Int {
+            return quantizedLines.reduce(MemoryLayout<Opening>.stride) { $0 + $1.byteCount + MemoryLayout<QuantizedPath>.stride }
+        }
+
+        // Calls `body` with the end points of every line segment
+        func forEachSegment(_ body: (MKMapPoint, MKMapPoint) -> Void) {
+            let origin = boundingRect.origin
+
+            for line in quantizedLines {
+                var previous: MKMapPoint?
+                line.forEachVertex { x, y in
+                    let current = MKMapPoint(x: origin.x + x / QuantizedPath.unitsPerMapPoint, y: origin.y + y / QuantizedPath.unitsPerMapPoint)
+                    if let previous = previous {
+                        body(previous, current)
+                    }
+                    previous = current
+                }
+            }
+        }
+    }
+
+    // An edge of a unit polygon ring
+    public struct BoundarySegment {
+        public let start: MKMapPoint
+        public let end: MKMapPoint
+        public let unitIndex: Int
+    }
+
+    public let levels: [Level]
+    public let units: [Unit]
+    public let boundarySegments: [BoundarySegment]
+    public let openings: [Opening]
+    public let venuePolygons: [Polygon]
+
+    // The resolved references of an IMDF archive, nil for AVF
+    let imdfRelationships: IMDFRelationships?
+
+    // Index in `units` of every IMDF unit in file order, IMDFRelationships.unresolved for units left out
+    private let imdfUnitIndices: [Int32]
+
+    // Sorted ordinal values of all levels
+    public let ordinalValues: [Int]
+
+    // Bounding rect of all levels and units
+    public let limitRect: MKMapRect
+
+    public let mapPointsPerMeter: Double
+
+    private let unitGrids: [Int: SpatialGrid]
+    private let openingGrids: [Int: SpatialGrid]
+    private let boundaryGrids: [Int: SpatialGrid]
+    private let venueOccupancyGrid: OccupancyGrid
+    private let levelOccupancyGrids: [Int: OccupancyGrid]
+
+    private static let gridCellSizeInMeters = 10.0
+
+    // IMDF unit categories that the app tests by their AVF names
+    private static let imdfCategories = [
+        "stairs": "Stairs",
+        "escalator": "Escalator",
+        "elevator": "Elevator",
+        "room": "Room",
+        "nonpublic": "Non-Public",
+        "opentobelow": "Open to Below"
+    ]
+
+    // Crossings this close to an opening pass through it, crossings this close to the ends of a move are touches
+    private static let wallToleranceInMeters = 0.25
+
+    // Reads an AVF directory, or an IMDF archive when the directory holds a level.geojson
+    public convenience init?(directoryPath: String) {
+        if FileManager.default.fileExists(atPath: (directoryPath as NSString).appendingPathComponent("level.geojson")) {
+            self.init(imdfDirectoryPath: directoryPath)
+        } else {
+            self.init(avfDirectoryPath: directoryPath)
+        }
+    }
+
+    private convenience init?(avfDirectoryPath directoryPath: String) {
+        guard let levelFeatures = VenueGeometry.features(inFile: "Levels", directoryPath: directoryPath),
+              let unitFeatures = VenueGeometry.features(inFile: "Units", directoryPath: directoryPath) else {
+            return nil
+        }
+
+        var ordinalValuesByLevel: [String: Int] = [:]
+        var levels: [Level] = []
+
+        for feature in levelFeatures {
+            guard let properties = feature["properties"] as? [String: Any],
+                  let identifier = properties["LEVEL_ID"] as? String,
+                  let ordinalValue = properties["ORDINAL"] as? Int else { continue }
+
+            ordinalValuesByLevel[identifier] = ordinalValue
+            levels.append(Level(identifier: identifier, ordinalValue: ordinalValue,
+                                polygons: VenueGeometry.polygons(of: feature["geometry"])))
+        }
+
+        var units: [Unit] = []
+
+        for feature in unitFeatures {
+            guard let properties = feature["properties"] as? [String: Any],
+                  let levelIdentifier = properties["LEVEL_ID"] as? String,
+                  let ordinalValue = ordinalValuesByLevel[levelIdentifier],
+                  let unit = Unit(identifier: properties["UNIT_ID"] as? String ?? "", category: properties["CATEGORY"] as? String ?? "",
+                                  ordinalValue: ordinalValue, geometry: feature["geometry"]) else { continue }
+
+            units.append(unit)
+        }
+
+        var openings: [Opening] = []
+
+        for feature in VenueGeometry.features(inFile: "Openings", directoryPath: directoryPath) ?? [] {
+            guard let properties = feature["properties"] as? [String: Any],
+                  let levelIdentifier = properties["LEVEL_ID"] as? String,
+                  let ordinalValue = ordinalValuesByLevel[levelIdentifier] else { continue }
+
+            let lines = VenueGeometry.lines(of: feature["geometry"])
+            guard !lines.isEmpty else { continue }
+
+            openings.append(Opening(identifier: properties["OPENING_ID"] as? String ?? "",
+                                    ordinalValue: ordinalValue,
+                                    lines: lines))
+        }
+
+        let venueFeatures = VenueGeometry.features(inFile: "Venue", directoryPath: directoryPath) ?? []
+
+        self.init(levels: levels, units: units, openings: openings,
+                  venuePolygons: venueFeatures.flatMap { VenueGeometry.polygons(of: $0["geometry"]) },
+                  imdfRelationships: nil, imdfUnitIndices: [])
+    }
+
+    // Floors come from the levels the IMDFRelationships resolved, every file is parsed once
+    private convenience init?(imdfDirectoryPath directoryPath: String) {
+        var featuresByLayer: [IMDFRelationships.Layer: [[String: Any]]] = [:]
+        for layer in IMDFRelationships.Layer.allCases {
+            featuresByLayer[layer] = VenueGeometry.features(inFile: layer.rawValue, directoryPath: directoryPath) ?? []
+        }
+
+        guard let relationships = IMDFRelationships(featuresByLayer: featuresByLayer) else { return nil }
+
+        let levels = (featuresByLayer[.level] ?? []).enumerated().map { levelIndex, feature in
+            Level(identifier: feature["id"] as? String ?? "", ordinalValue: relationships.levelOrdinals[levelIndex],
+                  polygons: VenueGeometry.polygons(of: feature["geometry"]))
+        }
+
+        var units: [Unit] = []
+        var unitIndices = [Int32](repeating: IMDFRelationships.unresolved, count: featuresByLayer[.unit]?.count ?? 0)
+
+        for (imdfIndex, feature) in (featuresByLayer[.unit] ?? []).enumerated() {
+            let properties = feature["properties"] as? [String: Any] ?? [:]
+            let category = properties["category"] as? String ?? ""
+
+            guard let ordinalValue = relationships.ordinalValue(ofUnit: imdfIndex),
+                  let unit = Unit(identifier: feature["id"] as? String ?? "", category: VenueGeometry.imdfCategories[category] ?? category,
+                                  ordinalValue: ordinalValue, geometry: feature["geometry"]) else { continue }
+
+            unitIndices[imdfIndex] = Int32(units.count)
+            units.append(unit)
+        }
+
+        var openings: [Opening] = []
+
+        for (imdfIndex, feature) in (featuresByLayer[.opening] ?? []).enumerated() {
+            let lines = VenueGeometry.lines(of: feature["geometry"])
+            guard let ordinalValue = relationships.ordinalValue(ofOpening: imdfIndex), !lines.isEmpty else { continue }
+
+            openings.append(Opening(identifier: feature["id"] as? String ?? "", ordinalValue: ordinalValue, lines: lines))
+        }
+
+        let venueFeatures = VenueGeometry.features(inFile: "venue", directoryPath: directoryPath) ?? []
+
+        self.init(levels: levels, units: units, openings: openings,
+                  venuePolygons: venueFeatures.flatMap { VenueGeometry.polygons(of: $0["geometry"]) },
+                  imdfRelationships: relationships, imdfUnitIndices: unitIndices)
+    }
+
+    private init(levels: [Level], units: [Unit], openings: [Opening], venuePolygons: [Polygon],
+                 imdfRelationships: IMDFRelationships?, imdfUnitIndices: [Int32]) {
+        let ordinalValues = Set(levels.map { $0.ordinalValue }).sorted()
+
+        let rects = levels.flatMap { $0.polygons.map { $0.boundingRect } } + units.map { $0.boundingRect }
+        let limitRect = rects.reduce(MKMapRect.null) { $0.union($1) }
+        let mapPointsPerMeter = MKMapPointsPerMeterAtLatitude(MKMapPoint(x: limitRect.midX, y: limitRect.midY).coordinate.latitude)
+
+        var boundarySegments: [BoundarySegment] = []
+        var boundarySegmentsByOrdinal: [Int: [(index: Int, rect: MKMapRect)]] = [:]
+
+        for (unitIndex, unit) in units.enumerated() {
+            for ring in unit.polygons.flatMap({ $0.rings }) {
+                for (a, b) in zip(ring, ring.dropFirst() + ring.prefix(1)) where a.x != b.x || a.y != b.y {
+                    boundarySegmentsByOrdinal[unit.ordinalValue, default: []].append((boundarySegments.count,
+                                                                                       VenueGeometry.boundingRect(of: [a, b])))
+                    boundarySegments.append(BoundarySegment(start: a, end: b, unitIndex: unitIndex))
+                }
+            }
+        }
+
+        let cellSize = VenueGeometry.gridCellSizeInMeters * mapPointsPerMeter
+        var unitGrids: [Int: SpatialGrid] = [:]
+        var openingGrids: [Int: SpatialGrid] = [:]
+        var boundaryGrids: [Int: SpatialGrid] = [:]
+        var levelOccupancyGrids: [Int: OccupancyGrid] = [:]
+
+        for ordinalValue in ordinalValues {
+            let ordinalUnits = units.indices.filter { units[$0].ordinalValue == ordinalValue }.map { (index: $0, rect: units[$0].boundingRect) }
+            let ordinalOpenings = openings.indices.filter { openings[$0].ordinalValue == ordinalValue }.map { (index: $0, rect: openings[$0].boundingRect) }
+
+            unitGrids[ordinalValue] = SpatialGrid(bounds: limitRect, cellSize: cellSize, items: ordinalUnits)
+            openingGrids[ordinalValue] = SpatialGrid(bounds: limitRect, cellSize: cellSize, items: ordinalOpenings)
+            boundaryGrids[ordinalValue] = SpatialGrid(bounds: limitRect, cellSize: cellSize, items: boundarySegmentsByOrdinal[ordinalValue] ?? [])
+            levelOccupancyGrids[ordinalValue] = OccupancyGrid(polygons: levels.filter { $0.ordinalValue == ordinalValue }.flatMap { $0.polygons })
+        }
+
+        self.levels = levels
+        self.units = units
+        self.boundarySegments = boundarySegments
+        self.openings = openings
+        self.venuePolygons = venuePolygons
+        self.ordinalValues = ordinalValues
+        self.limitRect = limitRect
+        self.mapPointsPerMeter = mapPointsPerMeter
+        self.unitGrids = unitGrids
+        self.openingGrids = openingGrids
+        self.boundaryGrids = boundaryGrids
+        self.venueOccupancyGrid = OccupancyGrid(polygons: venuePolygons)
+        self.imdfRelationships = imdfRelationships
+        self.imdfUnitIndices = imdfUnitIndices
+        self.levelOccupancyGrids = levelOccupancyGrids
+    }
+
+    public func isInsideVenue(_ point: MKMapPoint) -> Bool {
+        return venueOccupancyGrid.contains(point)
+    }
+
+    public func isInsideLevel(_ point: MKMapPoint, ordinalValue: Int) -> Bool {
+        return levelOccupancyGrids[ordinalValue]?.contains(point) ?? false
+    }
+
+    // Ordinals whose level footprint contains the point, in ascending order
+    public func ordinalValues(containing point: MKMapPoint) -> [Int] {
+        return ordinalValues.filter { isInsideLevel(point, ordinalValue: $0) }
+    }
+
+    // Approximate memory used by the geometry and its indices, in bytes
+    public var byteCount: Int {
+        return layerByteCounts.values.reduce(indexByteCount, +)
+    }
+
+    // Bytes of the records and geometry of each layer, by layer file name
+    public var layerByteCounts: [String: Int] {
+        func byteCount(of polygons: [Polygon]) -> Int {
+            return polygons.reduce(0) { $0 + $1.byteCount }
+        }
+
+        return [
+            "Levels": levels.reduce(levels.count * MemoryLayout<Level>.stride) { $0 + byteCount(of: $1.polygons) },
+            "Units": units.reduce(units.count * MemoryLayout<Unit>.stride + boundarySegments.count * MemoryLayout<BoundarySegment>.stride) {
+                $0 + byteCount(of: $1.polygons)
+            },
+            "Openings": openings.reduce(0) { $0 + $1.byteCount },
+            "Venue": byteCount(of: venuePolygons)
+        ]
+    }
+
+    // Bytes of the spatial grids and occupancy grids
+    public var indexByteCount: Int {
+        return [unitGrids, openingGrids, boundaryGrids].joined().reduce(0) { $0 + $1.value.byteCount }
+            + levelOccupancyGrids.values.reduce(venueOccupancyGrid.byteCount) { $0 + $1.byteCount }
+    }
+
+    // Index in `units` of the unit at this position in the IMDF unit file
+    func unitIndex(ofIMDFUnit imdfIndex: Int) -> Int? {
+        guard imdfUnitIndices.indices.contains(imdfIndex), imdfUnitIndices[imdfIndex] != IMDFRelationships.unresolved else { return nil }
+
+        return Int(imdfUnitIndices[imdfIndex])
+    }
+
+    // Index in `units` of the unit containing the point, `hint` is tested first when given
+    public func unitIndex(containing point: MKMapPoint, ordinalValue: Int, hint: Int? = nil) -> Int? {
+        if let hint = hint, units[hint].ordinalValue == ordinalValue, units[hint].contains(point) {
+            return hint
+        }
+
+        return unitGrids[ordinalValue]?.items(at: point).first { $0 != hint && units[$0].contains(point) }
+    }
+
+    // Checks if the straight move between two points passes through an opening line
+    public func crossesOpening(from start: MKMapPoint, to end: MKMapPoint, ordinalValue: Int) -> Bool {
+        guard let grid = openingGrids[ordinalValue] else { return false }
+
+        let rect = VenueGeometry.boundingRect(of: [start, end])
+        var crosses = false
+
+        grid.forEachItem(in: rect) { index in
+            guard !crosses, openings[index].boundingRect.intersects(rect) else { return }
+
+            openings[index].forEachSegment { a, b in
+                if !crosses, VenueGeometry.segmentsIntersect(start, end, a, b) {
+                    crosses = true
+                }
+            }
+        }
+
+        return crosses
+    }
+
+    // Indices in `boundarySegments` of the unit edges of the floor whose bounding rect may intersect `rect`,
+    // an index can be reported more than once
+    public func forEachBoundarySegment(in rect: MKMapRect, ordinalValue: Int, _ body: (Int) -> Void) {
+        boundaryGrids[ordinalValue]?.forEachItem(in: rect, body)
+    }
+
+    // Checks if the straight move between two points passes through a unit edge anywhere but at an opening.
+    // Touching an edge at either end of the move does not count, so moves may start and end on walls.
+    public func crossesWall(from start: MKMapPoint, to end: MKMapPoint, ordinalValue: Int) -> Bool {
+        let length = hypot(end.x - start.x, end.y - start.y)
+        guard length > 0, let grid = boundaryGrids[ordinalValue] else { return false }
+
+        let tolerance = VenueGeometry.wallToleranceInMeters * mapPointsPerMeter
+        let openings = openingSegments(crossedFrom: start, to: end, ordinalValue: ordinalValue)
+        var crosses = false
+
+        grid.forEachItem(in: VenueGeometry.boundingRect(of: [start, end])) { index in
+            let segment = boundarySegments[index]
+            guard !crosses, VenueGeometry.segmentsIntersect(start, end, segment.start, segment.end) else { return }
+
+            let a = segment.start, b = segment.end
+            let denominator = (end.x - start.x) * (b.y - a.y) - (end.y - start.y) * (b.x - a.x)
+            let t = ((a.x - start.x) * (b.y - a.y) - (a.y - start.y) * (b.x - a.x)) / denominator
+            guard t * length > tolerance, (1 - t) * length > tolerance else { return }
+
+            let crossing = MKMapPoint(x: start.x + t * (end.x - start.x), y: start.y + t * (end.y - start.y))
+            if !openings.contains(where: { VenueGeometry.distance(from: crossing, toSegmentFrom: $0.0, to: $0.1) <= tolerance }) {
+                crosses = true
+            }
+        }
+
+        return crosses
+    }
+
+    // Opening segments crossed by the straight move between two points, in the order they are crossed
+    public func openingSegments(crossedFrom start: MKMapPoint, to end: MKMapPoint, ordinalValue: Int) -> [(MKMapPoint, MKMapPoint)] {
+        guard let grid = openingGrids[ordinalValue] else { return [] }
+
+        let rect = VenueGeometry.boundingRect(of: [start, end])
+        var crossings: [(t: Double, segment: (MKMapPoint, MKMapPoint))] = []
+        var visited = Set<Int>()
+
+        grid.forEachItem(in: rect) { index in
+            guard visited.insert(index).inserted, openings[index].boundingRect.intersects(rect) else { return }
+
+            openings[index].forEachSegment { a, b in
+                guard VenueGeometry.segmentsIntersect(start, end, a, b) else { return }
+
+                // Position of the crossing along start -> end
+                let denominator = (end.x - start.x) * (b.y - a.y) - (end.y - start.y) * (b.x - a.x)
+                let t = ((a.x - start.x) * (b.y - a.y) - (a.y - start.y) * (b.x - a.x)) / denominator
+                crossings.append((t, (a, b)))
+            }
+        }
+
+        return crossings.sorted { $0.t < $1.t }.map { $0.segment }
+    }
+
+    // MARK: - GeoJSON
+
+    static func features(inFile name: String, directoryPath: String) -> [[String: Any]]? {
+        let path = (directoryPath as NSString).appendingPathComponent("\(name).geojson")
+
+        guard let data = FileManager.default.contents(atPath: path),
+              let object = try? JSONSerialization.jsonObject(with: data) as? [String: Any] else {
+            return nil
+        }
+
+        return object["features"] as? [[String: Any]]
+    }
+
+    private static func polygons(of geometry: Any?) -> [Polygon] {
+        guard let geometry = geometry as? [String: Any], let type = geometry["type"] as? String else { return [] }
+
+        let coordinates: [[[[Double]]]]
+        switch type {
+        case "Polygon":
+            coordinates = [geometry["coordinates"] as? [[[Double]]] ?? []]
+        case "MultiPolygon":
+            coordinates = geometry["coordinates"] as? [[[[Double]]]] ?? []
+        default:
+            return []
+        }
+
+        return coordinates.compactMap { polygon in
+            let rings = polygon.map(mapPoints(of:)).filter { $0.count >= 3 }
+            guard let exterior = rings.first else { return nil }
+
+            return Polygon(rings: rings, boundingRect: boundingRect(of: exterior))
+        }
+    }
+
+    private static func lines(of geometry: Any?) -> [[MKMapPoint]] {
+        guard let geometry = geometry as? [String: Any], let type = geometry["type"] as? String else { return [] }
+
+        let coordinates: [[[Double]]]
+        switch type {
+        case "LineString":
+            coordinates = [geometry["coordinates"] as? [[Double]] ?? []]
+        case "MultiLineString":
+            coordinates = geometry["coordinates"] as? [[[Double]]] ?? []
+        default:
+            return []
+        }
+
+        return coordinates.map(mapPoints(of:)).filter { $0.count >= 2 }
+    }
+
+    private static func mapPoints(of positions: [[Double]]) -> [MKMapPoint] {
+        return MercatorProjection.mapPoints(of: positions)
+    }
+
+    static func boundingRect<S: Sequence>(of points: S) -> MKMapRect where S.Element == MKMapPoint {
+        var minX = Double.infinity, minY = Double.infinity
+        var maxX = -Double.infinity, maxY = -Double.infinity
+
+        for point in points {
+            minX = min(minX, point.x)
+            minY = min(minY, point.y)
+            maxX = max(maxX, point.x)
+            maxY = max(maxY, point.y)
+        }
+
+        guard minX <= maxX else { return .null }
+
+        return MKMapRect(x: minX, y: minY, width: maxX - minX, height: maxY - minY)
+    }
+
+    static func distance(from point: MKMapPoint, toSegmentFrom a: MKMapPoint, to b: MKMapPoint) -> Double {
+        let dx = b.x - a.x, dy = b.y - a.y
+        let lengthSquared = dx * dx + dy * dy
+        let t = lengthSquared > 0 ? min(max(((point.x - a.x) * dx + (point.y - a.y) * dy) / lengthSquared, 0), 1) : 0
+
+        return hypot(point.x - (a.x + t * dx), point.y - (a.y + t * dy))
+    }
+
+    static func segmentsIntersect(_ p1: MKMapPoint, _ p2: MKMapPoint, _ q1: MKMapPoint, _ q2: MKMapPoint) -> Bool {
+        func cross(_ o: MKMapPoint, _ a: MKMapPoint, _ b: MKMapPoint) -> Double {
+            return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x)
+        }
+
+        let d1 = cross(q1, q2, p1), d2 = cross(q1, q2, p2)
+        let d3 = cross(p1, p2, q1), d4 = cross(p1, p2, q2)
+
+        return (d1 > 0) != (d2 > 0) && (d3 > 0) != (d4 > 0)
+    }
+}
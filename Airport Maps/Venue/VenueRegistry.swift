@@ -0,0 +1,381 @@
+//
+//  VenueRegistry.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import UIKit
+import MapKit
+import os.log
+
+// A venue kept in memory by the VenueRegistry: the PC_IndoorMapManager holding its features
+// and the VenueGeometry used for app side spatial queries.
+final class ResidentVenue {
+    enum State {
+        case loading, loaded, failed
+    }
+
+    let airportCode: String
+    let directoryPath: String
+    let mapManager = PC_IndoorMapManager()
+
+    private(set) var geometry: VenueGeometry?
+    private(set) var state = State.loading
+
+    // All loaded features, in load order
+    private(set) var features: [PC_IndoorMapFeature] = []
+
+    // Loaded features by the identifier of their own layer, or for IMDF the feature identifier.
+    // Features without one, such as the details, are only in `features`.
+    private(set) var featuresByIdentifier: [String: PC_IndoorMapFeature] = [:]
+    private var removedFeatureIndices = Set<Int>()
+
+    // The identifier property of the features of each AVF layer
+    private static let identifierKeys: [PC_IndoorMapLayerType: String] = [
+        .occupants: "OCCU_ID",
+        .points: "POINT_ID",
+        .units: "UNIT_ID",
+        .openings: "OPENING_ID",
+        .fixtures: "FIXTURE_ID",
+        .anchors: "ID",
+        .levels: "LEVEL_ID",
+        .buildings: "BLDG_ID",
+        .venue: "VENUE_ID"
+    ]
+
+    static func identifier(of feature: PC_IndoorMapFeature) -> String? {
+        if let identifier = feature.identifier {
+            return identifier
+        }
+
+        return identifierKeys[feature.layer.layerType].flatMap { feature.string(forKey: $0) }
+    }
+
+    // Size of the GeoJSON files by layer name, used as an estimate of the memory held by the manager's features
+    let sourceByteCounts: [String: Int]
+
+    var sourceByteCount: Int {
+        return sourceByteCounts.values.reduce(0, +)
+    }
+
+    var byteCount: Int {
+        return MemoryReport(venue: self).byteCount
+    }
+
+    // Built on first use, the venue must be loaded by then. The built* properties are nil until then,
+    // so memory accounting can look at them without building anything.
+    var navigationGraph: NavigationGraph? {
+        if builtNavigationGraph == nil {
+            builtNavigationGraph = geometry.map(NavigationGraph.init(geometry:))
+        }
+
+        return builtNavigationGraph
+    }
+
+    var routePlanner: RoutePlanner? {
+        if builtRoutePlanner == nil, let graph = navigationGraph, let geometry = geometry {
+            builtRoutePlanner = RoutePlanner(graph: graph, geometry: geometry)
+        }
+
+        return builtRoutePlanner
+    }
+
+    var routeStepBuilder: RouteStepBuilder? {
+        if builtRouteStepBuilder == nil, let geometry = geometry {
+            let landmarkIndex = LandmarkIndex(features: features.filter { !isFeatureRemoved($0) }, limitRect: geometry.limitRect,
+                                              mapPointsPerMeter: geometry.mapPointsPerMeter)
+            builtRouteStepBuilder = RouteStepBuilder(geometry: geometry, landmarkIndex: landmarkIndex)
+        }
+
+        return builtRouteStepBuilder
+    }
+
+    // Features by the index of the unit they are in, features outside the units are left out.
+    // IMDF features follow their resolved unit references, others are placed by their location.
+    var featuresByUnit: [Int: [PC_IndoorMapFeature]] {
+        if builtFeaturesByUnit == nil, let geometry = geometry {
+            var featuresByUnit: [Int: [PC_IndoorMapFeature]] = [:]
+            for feature in features {
+                if let relationships = geometry.imdfRelationships, let identifier = feature.identifier,
+                   let layer = IMDFRelationships.Layer(layerType: feature.layer.layerType),
+                   let index = relationships.index(of: identifier, in: layer) {
+                    let unitIndices = relationships.unitIndices(ofFeatureAt: index, in: layer).compactMap(geometry.unitIndex(ofIMDFUnit:))
+                    if !unitIndices.isEmpty {
+                        unitIndices.forEach { featuresByUnit[$0, default: []].append(feature) }
+                        continue
+                    }
+                }
+
+                guard let location = feature.location,
+                      let unitIndex = geometry.unitIndex(containing: location.mapPoint, ordinalValue: location.ordinalValue) else { continue }
+
+                featuresByUnit[unitIndex, default: []].append(feature)
+            }
+            builtFeaturesByUnit = featuresByUnit
+        }
+
+        return builtFeaturesByUnit ?? [:]
+    }
+
+    // Snapshot for queries off the main queue, see `publishSnapshot(completion:)`
+    let snapshotPublisher = VenueSnapshotPublisher()
+
+    private(set) var builtNavigationGraph: NavigationGraph?
+    private(set) var builtRoutePlanner: RoutePlanner?
+    private(set) var builtRouteStepBuilder: RouteStepBuilder?
+    private(set) var builtFeaturesByUnit: [Int: [PC_IndoorMapFeature]]?
+
+    func isFeatureRemoved(_ feature: PC_IndoorMapFeature) -> Bool {
+        return removedFeatureIndices.contains(feature.globalIndex)
+    }
+
+    func markFeatureRemoved(_ feature: PC_IndoorMapFeature) {
+        removedFeatureIndices.insert(feature.globalIndex)
+    }
+
+    // Drops the structures that copy feature properties, they are built again on next use
+    func invalidateFeatureCaches() {
+        builtRouteStepBuilder = nil
+        builtFeaturesByUnit = nil
+    }
+
+    // The manager's search, without the features removed by a venue delta
+    func searchString(_ string: String, inField field: String, location: PC_IndoorMapLocation?) -> [PC_IndoorMapFeature] {
+        return Trace.span("search") {
+            mapManager.searchString(string, inField: field, location: location).filter { !isFeatureRemoved($0) }
+        }
+    }
+
+    fileprivate final class Attachment {
+        weak var mapView: (PC_IndoorMapViewProtocol & UIView)?
+        weak var delegate: (NSObject & PC_IndoorMapManagerDelegate)?
+
+        init(mapView: PC_IndoorMapViewProtocol & UIView, delegate: NSObject & PC_IndoorMapManagerDelegate) {
+            self.mapView = mapView
+            self.delegate = delegate
+        }
+    }
+
+    fileprivate var lastAccess: UInt64 = 0
+    // Map views showing the venue, oldest first. The manager draws into the last one, when it is detached
+    // the manager moves back to the one before.
+    fileprivate var attachments: [Attachment] = []
+    fileprivate var attachCount: Int {
+        return attachments.count
+    }
+    fileprivate var waiters: [(ResidentVenue?) -> Void] = []
+
+    fileprivate init(airportCode: String, directoryPath: String) {
+        self.airportCode = airportCode
+        self.directoryPath = directoryPath
+
+        let fileNames = (try? FileManager.default.contentsOfDirectory(atPath: directoryPath)) ?? []
+        var sourceByteCounts: [String: Int] = [:]
+        for fileName in fileNames where fileName.hasSuffix(".geojson") {
+            let path = (directoryPath as NSString).appendingPathComponent(fileName)
+            let attributes = try? FileManager.default.attributesOfItem(atPath: path)
+
+            sourceByteCounts[(fileName as NSString).deletingPathExtension] = attributes?[.size] as? Int ?? 0
+        }
+        self.sourceByteCounts = sourceByteCounts
+    }
+
+    // Loads the features and the geometry side by side and calls `completion` once both are done
+    fileprivate func load(completion: @escaping () -> Void) {
+        var pendingCount = 2
+        var featuresLoaded = false
+        let loadStartTime = Trace.begin()
+        let finish = { [weak self] in
+            pendingCount -= 1
+            guard pendingCount == 0, let strongSelf = self else { return }
+
+            Trace.end("venueLoad", startTime: loadStartTime)
+            strongSelf.state = featuresLoaded ? .loaded : .failed
+            completion()
+        }
+
+        var features: [PC_IndoorMapFeature] = []
+        var featuresByIdentifier: [String: PC_IndoorMapFeature] = [:]
+        let onFeatureLoad: (PC_IndoorMapFeature, UnsafeMutablePointer<ObjCBool>, UnsafeMutablePointer<ObjCBool>) -> Void = { feature, _, _ in
+            features.append(feature)
+            if let identifier = ResidentVenue.identifier(of: feature), !identifier.isEmpty {
+                featuresByIdentifier[identifier] = feature
+            }
+        }
+
+        mapManager.loadVenueFromDirectory(atPath: directoryPath, options: [], onFeatureLoad: onFeatureLoad) { [weak self] finished in
+            self?.features = features
+            self?.featuresByIdentifier = featuresByIdentifier
+            featuresLoaded = finished
+            finish()
+        }
+
+        let directoryPath = self.directoryPath
+        DispatchQueue.global(qos: .utility).async { [weak self] in
+            let geometry = Trace.span("venueGeometry") { VenueGeometry(directoryPath: directoryPath) }
+
+            DispatchQueue.main.async {
+                self?.geometry = geometry
+                finish()
+            }
+        }
+    }
+}
+
+// Keeps recently used venues resident, so opening an airport again attaches the loaded
+// manager to the map view instead of parsing the venue once more. Venues that are not
+// attached to a map view are evicted, least recently used first, when the resident venues
+// exceed `byteBudget`. All methods must be called on the main queue.
+final class VenueRegistry {
+    static let shared = VenueRegistry()
+
+    var byteBudget = 256 * 1024 * 1024 {
+        didSet {
+            evictIfNeeded()
+        }
+    }
+
+    private var venues: [String: ResidentVenue] = [:]
+    private var accessCounter: UInt64 = 0
+
+    private init() {
+        NotificationCenter.default.addObserver(forName: UIApplication.didReceiveMemoryWarningNotification, object: nil,
+                                               queue: .main) { [weak self] _ in
+            #if DEBUG
+            self?.memoryReports.forEach { $0.log() }
+            #endif
+            self?.evictUnattachedVenues()
+        }
+    }
+
+    var residentByteCount: Int {
+        return venues.values.reduce(0) { $0 + $1.byteCount }
+    }
+
+    var residentAirportCodes: [String] {
+        return venues.values.sorted { $0.lastAccess > $1.lastAccess }.map { $0.airportCode }
+    }
+
+    // Breakdown of the memory of every resident venue, most recently used first
+    var memoryReports: [MemoryReport] {
+        return venues.values.sorted { $0.lastAccess > $1.lastAccess }.map(MemoryReport.init(venue:))
+    }
+
+    // Attaches the venue to the map view, loading it first when it is not resident.
+    // `completion` receives `nil` when the venue failed to load.
+    func attach(airportCode: String, to mapView: PC_IndoorMapViewProtocol & UIView, delegate: NSObject & PC_IndoorMapManagerDelegate,
+                completion: @escaping (ResidentVenue?) -> Void) {
+        let venue = residentVenue(airportCode: airportCode)
+        venue.attachments.removeAll { $0.mapView == nil || $0.mapView === mapView }
+        venue.attachments.append(ResidentVenue.Attachment(mapView: mapView, delegate: delegate))
+        venue.mapManager.delegate = delegate
+        venue.mapManager.setMapView(mapView)
+
+        whenLoaded(venue, completion: completion)
+    }
+
+    // Detaches the venue from the map view given to `attach`. Detaching another controller's map view
+    // leaves the manager where it is.
+    func detach(_ venue: ResidentVenue, from mapView: PC_IndoorMapViewProtocol & UIView) {
+        guard let index = venue.attachments.lastIndex(where: { $0.mapView === mapView }) else { return }
+
+        let wasDrawing = index == venue.attachments.count - 1
+        venue.attachments.remove(at: index)
+        venue.attachments.removeAll { $0.mapView == nil }
+
+        if wasDrawing {
+            let previous = venue.attachments.last
+            venue.mapManager.delegate = previous?.delegate
+            venue.mapManager.setMapView(previous?.mapView)
+        }
+
+        evictIfNeeded()
+    }
+
+    // Loads a venue in the background, for instance the next airport of an itinerary
+    func preload(airportCode: String, completion: ((ResidentVenue?) -> Void)? = nil) {
+        let venue = residentVenue(airportCode: airportCode)
+
+        whenLoaded(venue) { venue in
+            completion?(venue)
+        }
+    }
+
+    func evict(airportCode: String) {
+        guard let venue = venues[airportCode], venue.attachCount == 0 else { return }
+
+        venues[airportCode] = nil
+        os_log("Evicted venue %{public}@ (%ld bytes)", type: .info, airportCode, venue.byteCount)
+    }
+
+    private func residentVenue(airportCode: String) -> ResidentVenue {
+        accessCounter += 1
+
+        if let venue = venues[airportCode] {
+            venue.lastAccess = accessCounter
+            return venue
+        }
+
+        guard let directoryPath = Bundle.main.resourceURL?.appendingPathComponent("Maps/AVF/\(airportCode)").path else {
+            fatalError("Unable to find map data")
+        }
+
+        let venue = ResidentVenue(airportCode: airportCode, directoryPath: directoryPath)
+        venue.lastAccess = accessCounter
+        venues[airportCode] = venue
+
+        venue.load { [weak self, weak venue] in
+            guard let strongSelf = self, let venue = venue else { return }
+
+            let waiters = venue.waiters
+            venue.waiters = []
+
+            // A failed manager must not keep drawing into or calling back the controllers that attached it
+            if venue.state == .failed {
+                venue.attachments = []
+                venue.mapManager.setMapView(nil)
+                venue.mapManager.delegate = nil
+                strongSelf.venues[airportCode] = nil
+            }
+            #if DEBUG
+            if venue.state == .loaded {
+                MemoryReport(venue: venue).log()
+            }
+            #endif
+            waiters.forEach { $0(venue.state == .loaded ? venue : nil) }
+
+            strongSelf.evictIfNeeded()
+        }
+
+        return venue
+    }
+
+    private func whenLoaded(_ venue: ResidentVenue, completion: @escaping (ResidentVenue?) -> Void) {
+        switch venue.state {
+        case .loading:
+            venue.waiters.append(completion)
+        case .loaded:
+            completion(venue)
+        case .failed:
+            completion(nil)
+        }
+    }
+
+    private func evictIfNeeded() {
+        var byteCount = residentByteCount
+        guard byteCount > byteBudget else { return }
+
+        let candidates = venues.values.filter { $0.attachCount == 0 && $0.state != .loading }.sorted { $0.lastAccess < $1.lastAccess }
+        for venue in candidates where byteCount > byteBudget {
+            byteCount -= venue.byteCount
+            evict(airportCode: venue.airportCode)
+        }
+    }
+
+    private func evictUnattachedVenues() {
+        for venue in venues.values where venue.attachCount == 0 && venue.state != .loading {
+            evict(airportCode: venue.airportCode)
+        }
+    }
+}
@@ -0,0 +1,164 @@
+//
+//  VenueSnapshot.swift
+//  Airport Maps
+//
+//  Created by Bart Bruijnesteijn on 19/10/2026.
+//
+
+import MapKit
+import os
+
+// An immutable copy of the app side data of a loaded venue: the feature properties, a title search index,
+// the geometry and the navigation graph. Nothing in a snapshot changes after it is built, so any number of
+// threads can query it without locks. Changes publish a new snapshot that shares the unchanged parts with
+// the previous one; readers holding the old snapshot keep a consistent view until they let it go.
+final class VenueSnapshot {
+    struct Feature {
+        let identifier: String
+        let title: String?
+        let subtitle: String?
+        let categoryName: String?
+        let layerType: PC_IndoorMapLayerType
+        let mapPoint: MKMapPoint
+        let ordinalValue: Int
+    }
+
+    let version: Int
+    let geometry: VenueGeometry
+    let navigationGraph: NavigationGraph
+    let features: [Feature]
+
+    private let featureIndicesByIdentifier: [String: Int]
+
+    // Lowercased title words with the index of their feature, sorted for prefix search
+    private let searchKeys: [(word: String, featureIndex: Int32)]
+
+    init(version: Int, geometry: VenueGeometry, navigationGraph: NavigationGraph, features: [Feature]) {
+        var featureIndicesByIdentifier: [String: Int] = [:]
+        var searchKeys: [(word: String, featureIndex: Int32)] = []
+
+        for (index, feature) in features.enumerated() {
+            featureIndicesByIdentifier[feature.identifier] = index
+
+            for word in (feature.title ?? "").lowercased().split(whereSeparator: { !$0.isLetter && !$0.isNumber }) {
+                searchKeys.append((String(word), Int32(index)))
+            }
+        }
+        searchKeys.sort { $0.word < $1.word }
+
+        self.version = version
+        self.geometry = geometry
+        self.navigationGraph = navigationGraph
+        self.features = features
+        self.featureIndicesByIdentifier = featureIndicesByIdentifier
+        self.searchKeys = searchKeys
+    }
+
+    func feature(withIdentifier identifier: String) -> Feature? {
+        return featureIndicesByIdentifier[identifier].map { features[$0] }
+    }
+
+    // Features with a title word starting with `prefix`, in title order
+    func search(prefix: String) -> [Feature] {
+        return Trace.span("snapshotSearch") { search(lowercasedPrefix: prefix.lowercased()) }
+    }
+
+    private func search(lowercasedPrefix prefix: String) -> [Feature] {
+        guard !prefix.isEmpty else { return [] }
+
+        var lower = 0, upper = searchKeys.count
+        while lower < upper {
+            let middle = (lower + upper) / 2
+            if searchKeys[middle].word < prefix {
+                lower = middle + 1
+            } else {
+                upper = middle
+            }
+        }
+
+        var indices = Set<Int32>()
+        for key in searchKeys[lower...] {
+            guard key.word.hasPrefix(prefix) else { break }
+            indices.insert(key.featureIndex)
+        }
+
+        return indices.map { features[Int($0)] }.sorted { ($0.title ?? "") < ($1.title ?? "") }
+    }
+
+    // A new snapshot with other feature properties, sharing the geometry and the navigation graph
+    func replacingFeatures(_ features: [Feature]) -> VenueSnapshot {
+        return VenueSnapshot(version: version + 1, geometry: geometry, navigationGraph: navigationGraph, features: features)
+    }
+}
+
+// Holds the published snapshot of a venue. Reading takes the lock only to copy the reference, so readers never
+// wait on a snapshot being built and a publish never waits on readers.
+final class VenueSnapshotPublisher {
+    // On the heap, a stored os_unfair_lock has no stable address
+    private let lock: UnsafeMutablePointer<os_unfair_lock> = {
+        let lock = UnsafeMutablePointer<os_unfair_lock>.allocate(capacity: 1)
+        lock.initialize(to: os_unfair_lock())
+        return lock
+    }()
+    private var snapshot: VenueSnapshot?
+
+    deinit {
+        lock.deinitialize(count: 1)
+        lock.deallocate()
+    }
+
+    // Safe to call from any thread
+    var current: VenueSnapshot? {
+        os_unfair_lock_lock(lock)
+        defer { os_unfair_lock_unlock(lock) }
+
+        return snapshot
+    }
+
+    func publish(_ snapshot: VenueSnapshot) {
+        os_unfair_lock_lock(lock)
+        self.snapshot = snapshot
+        os_unfair_lock_unlock(lock)
+    }
+}
+
+private let snapshotQueue = DispatchQueue(label: "VenueSnapshot", qos: .utility)
+
+extension ResidentVenue {
+    // Copies the current feature properties, must be called on the main queue. Category names repeat across
+    // features and are interned, so features of one category share a single string.
+    func snapshotFeatures() -> [VenueSnapshot.Feature] {
+        let categoryNames = StringInterner()
+
+        return featuresByIdentifier.compactMap { identifier, feature in
+            guard !isFeatureRemoved(feature), let location = feature.location else { return nil }
+
+            return VenueSnapshot.Feature(identifier: identifier, title: LandmarkIndex.title(of: feature), subtitle: feature.subtitle,
+                                         categoryName: feature.categoryName.map(categoryNames.interned), layerType: feature.layer.layerType,
+                                         mapPoint: location.mapPoint, ordinalValue: location.ordinalValue)
+        }
+    }
+
+    // Publishes a snapshot of the loaded venue, or a new version of the published one with the current feature
+    // properties. The features are copied on the main queue, the indices are built on a serial background queue
+    // so snapshots are published in the order they were requested.
+    func publishSnapshot(completion: ((VenueSnapshot?) -> Void)? = nil) {
+        guard let geometry = geometry, let navigationGraph = navigationGraph else {
+            completion?(nil)
+            return
+        }
+
+        let features = snapshotFeatures()
+        let publisher = snapshotPublisher
+
+        snapshotQueue.async {
+            let snapshot = publisher.current?.replacingFeatures(features)
+                ?? VenueSnapshot(version: 1, geometry: geometry, navigationGraph: navigationGraph, features: features)
+            publisher.publish(snapshot)
+
+            DispatchQueue.main.async {
+                completion?(snapshot)
+            }
+        }
+    }
+}
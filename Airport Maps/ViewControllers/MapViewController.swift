@@ -9,10 +9,32 @@ import SwiftUI
 import UIKit
 import MapKit
 import CoreLocation
+import os.log
 
 class MapViewController: UIViewController, CLLocationManagerDelegate, PC_IndoorMapManagerDelegate {
-    private let pcMapManager = PC_IndoorMapManager()
+    private enum VenueState {
+        case notLoaded, loading, loaded
+    }
+
+    private var venue: ResidentVenue?
     private var pcMapView: (PC_IndoorMapViewProtocol & UIView)!
+    private let mapStyle = MapStyle(resource: "Maps/MapStyleSheet")
+
+    // Optional per-feature override, applied after the style sheet
+    var willDisplayFeatureOverlay: ((PC_IndoorMapFeatureOverlay) -> Void)?
+
+    private var venueState = VenueState.notLoaded
+    private var routeStepInstructions: [[Int]: String] = [:]
+
+    // Steps of the most recently calculated default route
+    private(set) var routeSteps: [RouteStepBuilder.Step] = []
+
+    // Steps of the completed routes planned with `planRoute`, by route identifier
+    private(set) var plannedRouteSteps: [String: [RouteStepBuilder.Step]] = [:]
+
+    // Called after every state change of a planned route, including the recalculations caused by overrides
+    var plannedRouteDidChangeState: ((RoutePlanner.PlannedRoute) -> Void)?
+    private var ordinalSwitchStartTime: CFTimeInterval?
 
     var airport: Airport
     var settings: Settings
@@ -36,6 +58,12 @@ class MapViewController: UIViewController, CLLocationManagerDelegate, PC_IndoorM
     required init?(coder: NSCoder) {
         fatalError("init(coder:) has not been implemented")
     }
+
+    deinit {
+        if let venue = venue {
+            VenueRegistry.shared.detach(venue, from: pcMapView)
+        }
+    }
     
     override func viewDidLoad() {
         super.viewDidLoad()
@@ -62,22 +90,42 @@ class MapViewController: UIViewController, CLLocationManagerDelegate, PC_IndoorM
         self.view.addSubview(mapView)
         
         pcMapView = mapView
-        pcMapManager.delegate = self
-        pcMapManager.setMapView(mapView)
 
         showMap()
     }
     
     public func showMap() {
-        guard let venueFolderPath = Bundle.main.resourceURL?.appendingPathComponent("Maps/AVF/\(self.airport.airportCode)").path else {
-            fatalError("Unable to find map data")
+        // A loaded venue only needs a floor change, reloading it would blank the map
+        switch venueState {
+        case .loaded:
+            showOrdinal()
+            return
+
+        case .loading:
+            return
+
+        case .notLoaded:
+            break
         }
 
-        pcMapManager.loadVenueFromDirectory(atPath: venueFolderPath, options: [],  onFeatureLoad: { (_, _, _) in
+        venueState = .loading
+
+        // A venue still resident from an earlier visit is attached without loading it again
+        let mapView: PC_IndoorMapViewProtocol & UIView = pcMapView
+        VenueRegistry.shared.attach(airportCode: airport.airportCode, to: mapView, delegate: self) { [weak self] venue in
+            guard let strongSelf = self else {
+                if let venue = venue {
+                    VenueRegistry.shared.detach(venue, from: mapView)
+                }
+                return
+            }
+
+            strongSelf.venue = venue
+            strongSelf.venueState = venue != nil ? .loaded : .notLoaded
 
-        }) { [weak self] finished in
-            guard let strongSelf = self, finished else { return }
+            guard let venue = venue else { return }
             strongSelf.centerMap()
+            strongSelf.startMapMatching(venue: venue)
         }
     }
     
@@ -86,48 +134,212 @@ class MapViewController: UIViewController, CLLocationManagerDelegate, PC_IndoorM
         let visibleRadialDistance = CLLocationDistance(Double(self.airport.airportRadius)!)
         
         pcMapView.setCenter(center, visibleRadialDistance: visibleRadialDistance, animated: true)
-        pcMapManager.ordinalValue = Int(settings.ordinal)!
+        venue?.mapManager.ordinalValue = Int(settings.ordinal)!
+    }
+
+    // Snap the blue dot to the venue geometry, a resident venue keeps its provider
+    private func startMapMatching(venue: ResidentVenue) {
+        guard let venueGeometry = venue.geometry, !(venue.mapManager.locationProvider is MapMatchingLocationProvider) else { return }
+
+        let fallbackOrdinalValue = venue.mapManager.ordinalValue
+        #if DEBUG
+        if let locationProvider = locationTraceProvider(venueGeometry: venueGeometry, fallbackOrdinalValue: fallbackOrdinalValue) {
+            venue.mapManager.locationProvider = locationProvider
+            return
+        }
+        #endif
+
+        venue.mapManager.locationProvider = MapMatchingLocationProvider(venueGeometry: venueGeometry,
+                                                                        fallbackOrdinalValue: fallbackOrdinalValue)
+    }
+
+    #if DEBUG
+    // The LocationTraceReplay default names a trace to replay instead of Core Location, -RecordLocationTrace
+    // records the walk to the Documents directory
+    private func locationTraceProvider(venueGeometry: VenueGeometry, fallbackOrdinalValue: Int) -> MapMatchingLocationProvider? {
+        if let tracePath = UserDefaults.standard.string(forKey: "LocationTraceReplay") {
+            guard let trace = LocationTrace(contentsOf: URL(fileURLWithPath: tracePath)) else {
+                os_log("Could not read location trace %{public}@", type: .error, tracePath)
+                return nil
+            }
+
+            let provider = LocationTraceReplayProvider(trace: trace, venueGeometry: venueGeometry, fallbackOrdinalValue: fallbackOrdinalValue)
+            provider.isRealTime = UserDefaults.standard.bool(forKey: "LocationTraceReplayRealTime")
+
+            return provider
+        }
+
+        if ProcessInfo.processInfo.arguments.contains("-RecordLocationTrace"),
+           let documentsURL = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first {
+            let traceURL = documentsURL.appendingPathComponent("\(airport.airportCode)-\(Int(Date().timeIntervalSince1970)).locationtrace")
+
+            return LocationTraceRecordingProvider(traceURL: traceURL, venueGeometry: venueGeometry, fallbackOrdinalValue: fallbackOrdinalValue)
+        }
+
+        return nil
+    }
+    #endif
+
+    // Applies shop, gate or other feature changes without reloading the venue
+    @discardableResult
+    public func applyVenueDelta(_ delta: VenueDelta) -> VenueDelta.Result? {
+        guard let venue = venue else { return nil }
+
+        let result = venue.apply(delta)
+        if !result.touchedFeatures.isEmpty {
+            routeStepInstructions = [:]
+        }
+        if !result.missingIdentifiers.isEmpty {
+            os_log("Venue delta references %ld unknown features", type: .error, result.missingIdentifiers.count)
+        }
+
+        return result
+    }
+
+    // Plans a route over the app side navigation graph. Unlike the manager's default route it follows the overrides
+    // set with `setRouteOverride` and the closures of venue deltas, see `plannedRouteDidChangeState`.
+    @discardableResult
+    public func planRoute(identifier: String, from start: PC_IndoorMapLocation, to end: PC_IndoorMapLocation,
+                          navigationIndex: Int = 0) -> RoutePlanner.PlannedRoute? {
+        guard let routePlanner = venue?.routePlanner else { return nil }
+
+        // The planner stays with the resident venue, the controller showing it observes the routes
+        routePlanner.routeDidChangeState = { [weak self] route in
+            self?.routeDidChangeState(route)
+        }
+
+        let request = RoutePlanner.Request(start: start.mapPoint, fromOrdinalValue: start.ordinalValue, end: end.mapPoint,
+                                           toOrdinalValue: end.ordinalValue, profile: NavigationGraph.Profile(navigationIndex: navigationIndex))
+
+        return routePlanner.makeRoute(identifier: identifier, request: request)
+    }
+
+    public func removePlannedRoute(identifier: String) {
+        guard let routePlanner = venue?.routePlanner, let route = routePlanner.route(forIdentifier: identifier) else { return }
+
+        routePlanner.removeRoute(route)
+    }
+
+    private func routeDidChangeState(_ route: RoutePlanner.PlannedRoute) {
+        if route.state == .completed, let path = route.route?.vertices, let builder = venue?.routeStepBuilder, let geometry = venue?.geometry {
+            plannedRouteSteps[route.identifier] = Trace.span("routeSteps") {
+                builder.steps(for: PathSmoother.smooth(path, geometry: geometry))
+            }
+        } else {
+            plannedRouteSteps[route.identifier] = nil
+        }
+
+        plannedRouteDidChangeState?(route)
+    }
+
+    // Closes or slows down a unit, connector or opening, the planned routes crossing it are calculated again
+    @discardableResult
+    public func setRouteOverride(_ override: NavigationMetric.Override?, forFeatureIdentifier identifier: String) -> Bool {
+        guard let routePlanner = venue?.routePlanner else { return false }
+
+        return routePlanner.setOverride(override, forFeatureIdentifier: identifier)
+    }
+
+    // Features and areas within `time` seconds walk of the location
+    public func isochrone(from location: PC_IndoorMapLocation, time: TimeInterval, navigationIndex: Int = 0) -> Isochrone? {
+        return venue?.isochrone(from: location, time: time, navigationIndex: navigationIndex)
+    }
+
+    // Features matching the search string, features removed by a venue delta are left out
+    public func searchFeatures(_ string: String, inField field: String = "NAME") -> [PC_IndoorMapFeature] {
+        return venue?.searchString(string, inField: field, location: nil) ?? []
+    }
+
+    private func showOrdinal() {
+        guard let mapManager = venue?.mapManager else { return }
+
+        let ordinalValue = Int(settings.ordinal)!
+        guard mapManager.ordinalValue != ordinalValue else { return }
+
+        ordinalSwitchStartTime = CACurrentMediaTime()
+        mapManager.ordinalValue = ordinalValue
     }
 
     // PC_IndoorMapManagerDelegate methods
     func indoorMapManager(_ manager: PC_IndoorMapManager, willDisplay featureOverlay: PC_IndoorMapFeatureOverlay) {
-        // No drawing by default
-        featureOverlay.renderer = nil
+        let startTime = Trace.begin()
+        defer { Trace.end("willDisplayFeatureOverlay", startTime: startTime) }
 
-        // Conditional drawing for certain objects
-        switch featureOverlay.feature.layer.layerType {
+        // Features removed by a venue delta are kept by the manager but not drawn
+        if let venue = venue, venue.isFeatureRemoved(featureOverlay.feature) {
+            featureOverlay.renderer = nil
+            return
+        }
 
-        case .units:
-            guard let categoryName = featureOverlay.feature.categoryName else { break }
+        Trace.span("renderPrep.style") {
+            mapStyle.apply(to: featureOverlay)
+        }
 
-            let renderer = PC_IndoorMapRenderer()
-            featureOverlay.renderer = renderer
-            renderer.strokeWidth = 0.5
+        willDisplayFeatureOverlay?(featureOverlay)
+    }
 
-            if categoryName == "Room" || categoryName == "room" {
-                renderer.strokeColor = UIColor.black
-                renderer.fillColor = UIColor.white
-                break
-            }
+    func indoorMapManager(_ manager: PC_IndoorMapManager, routeStepInstructionForFeatures features: [PC_IndoorMapFeature],
+                          ordinalValue: Int) -> String {
+        // Recomputed routes pass the same features again
+        let key = features.map { $0.globalIndex }
+        if let instruction = routeStepInstructions[key] {
+            return instruction
+        }
 
-            if categoryName.contains("Stairs") || categoryName.contains("Escalator") ||
-                categoryName.contains("Elevator") {
-                renderer.strokeColor = UIColor.black
-                renderer.fillColor = UIColor.white
-                break
-            }
+        let landmark = features.filter { LandmarkIndex.landmarkLayerTypes.contains($0.layer.layerType) && LandmarkIndex.title(of: $0) != nil }
+            .min { LandmarkIndex.rank(of: $0.layer.layerType) < LandmarkIndex.rank(of: $1.layer.layerType) }
 
-            renderer.strokeColor = UIColor.black
+        let instruction: String
+        if let title = landmark.flatMap(LandmarkIndex.title(of:)) {
+            instruction = String(format: NSLocalizedString("RouteStepContinuePast", value: "Continue past %@", comment: ""), title)
+        } else if let ordinalName = airport.ordinalName(for: ordinalValue) {
+            instruction = String(format: NSLocalizedString("RouteStepContinueTo", value: "Continue to %@", comment: ""), ordinalName)
+        } else {
+            instruction = NSLocalizedString("RouteStepContinue", value: "Continue", comment: "")
+        }
+        routeStepInstructions[key] = instruction
 
-        case .levels:
-            let renderer = PC_IndoorMapRenderer()
-            renderer.strokeColor = UIColor.black
-            renderer.fillColor = UIColor.white
-            featureOverlay.renderer = renderer
+        return instruction
+    }
 
-        default:
-            break
+    func indoorMapManager(_ manager: PC_IndoorMapManager, defaultRouteDidCalculateDistance distance: CLLocationDistance,
+                          time: TimeInterval, steps: [PC_IndoorMapStep]?, destinationLocation: PC_IndoorMapLocation?,
+                          fromLocationServices: Bool, error: Error?) {
+        guard let builder = venue?.routeStepBuilder, let geometry = venue?.geometry, let steps = steps, error == nil else {
+            routeSteps = []
+            return
+        }
+
+        // Consecutive steps share their boundary point, it is added once
+        var path: [RouteStepBuilder.Vertex] = []
+        for step in steps {
+            let polyline = step.polyline
+            let points = polyline.points()
+            for index in 0..<polyline.pointCount {
+                if let last = path.last, last.ordinalValue == step.ordinal, last.mapPoint.x == points[index].x, last.mapPoint.y == points[index].y {
+                    continue
+                }
+                path.append(RouteStepBuilder.Vertex(mapPoint: points[index], ordinalValue: step.ordinal))
+            }
         }
+
+        routeSteps = Trace.span("routeSteps") {
+            builder.steps(for: PathSmoother.smooth(path, geometry: geometry))
+        }
+    }
+
+    // Answered from the venue's occupancy grid instead of a point in polygon test, the hint until the geometry is loaded
+    func indoorMapManager(_ manager: PC_IndoorMapManager, isPointInsideVenue point: MKMapPoint, isDestination: Bool, hint: Bool) -> Bool {
+        guard let geometry = venue?.geometry else { return hint }
+
+        return geometry.isInsideVenue(point)
+    }
+
+    func indoorMapManagerDidChangeOrdinal(_ manager: PC_IndoorMapManager) {
+        guard let startTime = ordinalSwitchStartTime else { return }
+        ordinalSwitchStartTime = nil
+
+        os_log("Switched to ordinal %ld in %.1f ms", type: .info, manager.ordinalValue, (CACurrentMediaTime() - startTime) * 1000)
     }
 
     // CLLocationManagerDelegate methods
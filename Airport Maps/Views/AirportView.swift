@@ -24,7 +24,7 @@ struct AirportView: View {
             HStack {
                 Spacer()
                 
-                Button(airports.maps[index].airportOrdinalNames[Int(settings.ordinal)!]) {
+                Button(airports.maps[index].ordinalName(for: Int(settings.ordinal)!) ?? "") {
                     self.actionsheetIsPresented = true
                 }
                 .frame(minWidth: 0, idealWidth: .infinity, maxWidth: .infinity, minHeight:
@@ -23,7 +23,7 @@ struct SelectFloorForAirportView: View {
             
             ForEach(airport.airportOrdinalNames.indices) { index in
                 Button(action: {
-                    settings.ordinal(ordinal: String(index))
+                    settings.ordinal(ordinal: String(airport.ordinalValue(forNameAt: index)))
                     
                     actionsheetIsPresented = false
                 }) {